@@ -0,0 +1,131 @@
+/**
+ * @file SimulatedBus.cpp
+ * @brief Simulated Modbus RTU segment for the native benchmark
+ *
+ * Answers register reads from in-memory register tables and models
+ * the time the transaction would take on a real bus: request and
+ * response frames at the configured baud rate (11 bits per character),
+ * the 3.5 character inter-frame gap and the slave's response latency.
+ * Timeouts and CRC errors are injected at configurable rates with a
+ * fixed-seed generator, so runs are reproducible.
+ *
+ * Bus time is accumulated, not waited for; benchmarks report it next
+ * to the measured CPU time.
+ *
+ * @author Johannes
+ * @version 1.0
+ * @date 2025
+ */
+
+#include "SimulatedBus.h"
+
+// Frame sizes in bytes (slave ID, function code, CRC included)
+#define REQUEST_FRAME_BYTES 8   // Read request: ID, FC, address, count, CRC
+#define RESPONSE_HEADER_BYTES 5 // ID, FC, byte count, CRC
+#define EXCEPTION_FRAME_BYTES 5 // ID, FC | 0x80, exception code, CRC
+
+SimulatedBus::SimulatedBus(const SimulatedBusConfig &config)
+    : _config(config), _busTimeUs(0), _requests(0), _failures(0), _random(12345) {
+}
+
+void SimulatedBus::addSlave(uint8_t slaveId, ModbusRegisterType type, uint16_t firstRegister,
+                            uint16_t count) {
+    Slave slave;
+    slave.id = slaveId;
+    slave.type = type;
+    slave.firstRegister = firstRegister;
+    slave.registers.assign(count, 0);
+    _slaves.push_back(slave);
+}
+
+void SimulatedBus::setRegister(uint8_t slaveId, ModbusRegisterType type, uint16_t address,
+                               uint16_t value) {
+    Slave *slave = findSlave(slaveId, type);
+    if (slave != nullptr && address >= slave->firstRegister &&
+        (size_t)(address - slave->firstRegister) < slave->registers.size()) {
+        slave->registers[address - slave->firstRegister] = value;
+    }
+}
+
+/**
+ * @brief Answer a register read like a slave on the bus would
+ *
+ * Unknown slaves time out. Reads outside the register range or above
+ * maxRegisters get an exception response.
+ */
+uint8_t SimulatedBus::readRegisters(uint8_t slaveId, ModbusRegisterType type, uint16_t address,
+                                    uint16_t count, uint16_t *words) {
+    _requests++;
+    _busTimeUs += frameTimeUs(REQUEST_FRAME_BYTES);
+
+    Slave *slave = findSlave(slaveId, type);
+    if (slave == nullptr || nextRandom() < _config.timeoutRate) {
+        _busTimeUs += _config.timeoutUs;
+        _failures++;
+        return MODBUS_RESULT_TIMEOUT;
+    }
+
+    _busTimeUs += _config.responseLatencyUs;
+
+    bool inRange = address >= slave->firstRegister &&
+                   address + count <= slave->firstRegister + slave->registers.size();
+    if (!inRange || (_config.maxRegisters != 0 && count > _config.maxRegisters)) {
+        _busTimeUs += frameTimeUs(EXCEPTION_FRAME_BYTES);
+        _failures++;
+        return inRange ? MODBUS_RESULT_ILLEGAL_DATA_VALUE : MODBUS_RESULT_ILLEGAL_DATA_ADDRESS;
+    }
+
+    _busTimeUs += frameTimeUs(RESPONSE_HEADER_BYTES + count * 2);
+    if (nextRandom() < _config.crcErrorRate) {
+        _failures++;
+        return MODBUS_RESULT_INVALID_CRC;
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        words[i] = slave->registers[address - slave->firstRegister + i];
+    }
+    return MODBUS_RESULT_SUCCESS;
+}
+
+uint64_t SimulatedBus::busTimeUs() const {
+    return _busTimeUs;
+}
+
+uint32_t SimulatedBus::requests() const {
+    return _requests;
+}
+
+uint32_t SimulatedBus::failures() const {
+    return _failures;
+}
+
+void SimulatedBus::resetStatistics() {
+    _busTimeUs = 0;
+    _requests = 0;
+    _failures = 0;
+}
+
+SimulatedBus::Slave *SimulatedBus::findSlave(uint8_t slaveId, ModbusRegisterType type) {
+    for (Slave &slave : _slaves) {
+        if (slave.id == slaveId && slave.type == type) {
+            return &slave;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Time of one frame including the following inter-frame gap
+ */
+uint32_t SimulatedBus::frameTimeUs(uint32_t bytes) const {
+    uint32_t gap = _config.baud > 19200 ? 1750 : (uint32_t)(3.5 * 11 * 1000000UL / _config.baud);
+    return (uint32_t)((uint64_t)bytes * 11 * 1000000UL / _config.baud) + gap;
+}
+
+/**
+ * @brief Uniform value in [0, 1) from a fixed-seed LCG
+ */
+float SimulatedBus::nextRandom() {
+    _random = _random * 1664525UL + 1013904223UL;
+    return (_random >> 8) / 16777216.0f;
+}
@@ -0,0 +1,56 @@
+#ifndef SIMULATED_BUS_H
+#define SIMULATED_BUS_H
+
+// Simulierter RS485-Bus mit Modbus-Slaves für den nativen Benchmark
+
+#include <stdint.h>
+#include <vector>
+#include "ModbusTransport.h"
+
+struct SimulatedBusConfig {
+    uint32_t baud;              // Baudrate für das Zeitmodell der Frames
+    uint32_t responseLatencyUs; // Verarbeitungszeit des Slaves bis zur Antwort
+    uint32_t timeoutUs;         // Verlorene Zeit ohne Antwort (ModbusMaster: 2000 ms)
+    float timeoutRate;          // Anteil Anfragen ohne Antwort (0..1)
+    float crcErrorRate;         // Anteil Antworten mit falscher CRC (0..1)
+    uint16_t maxRegisters;      // Größter akzeptierter Lesezugriff (0 = unbegrenzt)
+};
+
+class SimulatedBus : public ModbusTransport {
+public:
+    explicit SimulatedBus(const SimulatedBusConfig &config);
+
+    // Slave mit einem Registerbereich anlegen (alle Register 0)
+    void addSlave(uint8_t slaveId, ModbusRegisterType type, uint16_t firstRegister, uint16_t count);
+    void setRegister(uint8_t slaveId, ModbusRegisterType type, uint16_t address, uint16_t value);
+
+    uint8_t readRegisters(uint8_t slaveId, ModbusRegisterType type, uint16_t address,
+                          uint16_t count, uint16_t *words) override;
+
+    // Modellierte Buszeit (wird nicht tatsächlich abgewartet)
+    uint64_t busTimeUs() const;
+    uint32_t requests() const;
+    uint32_t failures() const;
+    void resetStatistics();
+
+private:
+    struct Slave {
+        uint8_t id;
+        ModbusRegisterType type;
+        uint16_t firstRegister;
+        std::vector<uint16_t> registers;
+    };
+
+    SimulatedBusConfig _config;
+    std::vector<Slave> _slaves;
+    uint64_t _busTimeUs;
+    uint32_t _requests;
+    uint32_t _failures;
+    uint32_t _random;
+
+    Slave *findSlave(uint8_t slaveId, ModbusRegisterType type);
+    uint32_t frameTimeUs(uint32_t bytes) const;
+    float nextRandom();
+};
+
+#endif // SIMULATED_BUS_H
@@ -0,0 +1,432 @@
+/**
+ * @file main.cpp
+ * @brief Native microbenchmarks of the firmware hot paths
+ *
+ * Runs the shared firmware modules (SensorCore, SensorFilter,
+ * AlarmEngine, LinkHealth, ModbusAcquisition, SensorRender,
+ * SnapshotBuffer) on the host against a simulated Modbus segment
+ * (SimulatedBus):
+ *
+ * - decode:   register block -> values for 8 channels
+ * - format:   fixed-point value -> text
+ * - filter:   median/EMA per value, window statistics add and query
+ * - alarm:    rule evaluation of one new reading
+ * - render:   /api/v1/sensordata JSON and binary payloads
+ * - pipeline: bus read -> decode -> readings -> filter -> snapshot ->
+ *             JSON cache, the path from a sample to its publication,
+ *             with the firmware's block/single read fallback and
+ *             backoff (ModbusAcquisition)
+ *
+ * Build and run:  pio run -e native && .pio/build/native/program
+ * Options (key=value): iterations, baud, latency (us), timeouts, crc
+ * (error rates 0..1), max_registers, dead (index of a device that
+ * never answers)
+ *
+ * Host timings are relative: compare runs on the same machine to spot
+ * regressions, not against ESP32 numbers.
+ *
+ * @author Johannes
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SensorCore.h"
+#include "SensorFilter.h"
+#include "AlarmEngine.h"
+#include "LinkHealth.h"
+#include "ModbusAcquisition.h"
+#include "SensorRender.h"
+#include "SensorSnapshot.h"
+#include "SimulatedBus.h"
+
+#define BENCH_MAX_SENSORS 16
+#define BENCH_JSON_SIZE (32 + BENCH_MAX_SENSORS * 128)
+
+// Bench bus: one float module on holding registers, one int16 module
+// on input registers
+struct BenchDevice {
+    uint8_t slaveId;
+    ModbusRegisterType registerType;
+    uint8_t firstChannel;
+    uint8_t channels;
+    uint16_t firstRegister;
+    uint16_t registerCount;
+};
+
+const SensorChannel BENCH_CHANNELS[] = {
+    {0, 0x30, FORMAT_FLOAT_ABCD, 1.0f, "Flow"},
+    {0, 0x32, FORMAT_FLOAT_ABCD, 1.0f, "Return"},
+    {0, 0x34, FORMAT_FLOAT_ABCD, 1.0f, "Buffer top"},
+    {0, 0x36, FORMAT_FLOAT_ABCD, 1.0f, "Buffer mid"},
+    {0, 0x38, FORMAT_FLOAT_CDAB, 1.0f, "Buffer low"},
+    {0, 0x3A, FORMAT_FLOAT_CDAB, 1.0f, "Solar"},
+    {0, 0x3C, FORMAT_FLOAT_BADC, 1.0f, "DHW"},
+    {0, 0x3E, FORMAT_FLOAT_DCBA, 1.0f, "Circulation"},
+    {1, 0x00, FORMAT_INT16, 0.1f, "Outdoor"},
+    {1, 0x01, FORMAT_INT16, 0.1f, "Cellar"},
+    {1, 0x02, FORMAT_UINT16, 0.1f, "Living"},
+    {1, 0x03, FORMAT_INT16, 0.1f, "Attic"},
+};
+const int BENCH_SENSORS = sizeof(BENCH_CHANNELS) / sizeof(BENCH_CHANNELS[0]);
+
+const BenchDevice BENCH_DEVICES[] = {
+    {1, HOLDING_REGISTERS, 0, 8, 0x30, 16},
+    {2, INPUT_REGISTERS, 8, 4, 0x00, 4},
+};
+
+struct BenchSample {
+    SensorReading readings[BENCH_MAX_SENSORS];
+    uint32_t timestamp;
+};
+
+struct BenchJson {
+    uint16_t length;
+    char payload[BENCH_JSON_SIZE];
+};
+
+struct BenchOptions {
+    uint32_t iterations;
+    SimulatedBusConfig bus;
+    int deadDevice; // Device left off the bus (-1 = none)
+};
+
+// Same limits as the firmware defaults (MODBUS_LINK_POLICY, MODBUS_RETRIES)
+const LinkPolicy BENCH_LINK_POLICY = {30000, 5, 60000};
+const uint8_t BENCH_RETRIES = 1;
+
+// Keeps results alive so the compiler cannot drop the measured work
+volatile uint32_t benchSink;
+
+typedef std::chrono::steady_clock BenchClock;
+
+static double elapsedNs(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+}
+
+static void printResult(const char *name, double nsPerOp, const char *note) {
+    printf("%-28s %12.1f ns/op %14.0f op/s  %s\n", name, nsPerOp, 1e9 / nsPerOp, note);
+}
+
+/**
+ * @brief Run a body repeatedly and print the mean time per call
+ */
+template <typename Body>
+static void runBenchmark(const char *name, uint32_t iterations, Body body, const char *note = "") {
+    // Warm-up (caches, lazy allocations)
+    for (uint32_t i = 0; i < iterations / 10 + 1; i++) {
+        body(i);
+    }
+
+    BenchClock::time_point start = BenchClock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        body(i);
+    }
+    printResult(name, elapsedNs(start) / iterations, note);
+}
+
+/**
+ * @brief Encode a temperature into registers in the given format
+ */
+static void encodeValue(ChannelFormat format, float celsius, float scale, uint16_t *words) {
+    union {
+        uint32_t i;
+        float f;
+    } converter;
+    converter.f = celsius / scale;
+    uint16_t high = converter.i >> 16;
+    uint16_t low = converter.i & 0xFFFF;
+
+    switch (format) {
+    case FORMAT_FLOAT_ABCD: words[0] = high; words[1] = low; break;
+    case FORMAT_FLOAT_CDAB: words[0] = low; words[1] = high; break;
+    case FORMAT_FLOAT_BADC: words[0] = __builtin_bswap16(high); words[1] = __builtin_bswap16(low); break;
+    case FORMAT_FLOAT_DCBA: words[0] = __builtin_bswap16(low); words[1] = __builtin_bswap16(high); break;
+    case FORMAT_INT16: words[0] = (uint16_t)(int16_t)(celsius / scale); break;
+    case FORMAT_UINT16: words[0] = (uint16_t)(celsius / scale); break;
+    case FORMAT_INT32: {
+        uint32_t raw = (uint32_t)(int32_t)(celsius / scale);
+        words[0] = raw >> 16;
+        words[1] = raw & 0xFFFF;
+        break;
+    }
+    default: break;
+    }
+}
+
+/**
+ * @brief Load a slowly changing temperature profile into the simulated slaves
+ */
+static void loadRegisters(SimulatedBus &bus, uint32_t step) {
+    for (int c = 0; c < BENCH_SENSORS; c++) {
+        const SensorChannel &channel = BENCH_CHANNELS[c];
+        const BenchDevice &device = BENCH_DEVICES[channel.device];
+        uint16_t words[2];
+        float celsius = 20.0f + c * 2.5f + (step % 50) * 0.05f;
+        encodeValue(channel.format, celsius, channel.scale, words);
+        for (uint16_t w = 0; w < channelRegisterCount(channel.format); w++) {
+            bus.setRegister(device.slaveId, device.registerType, channel.registerAddress + w, words[w]);
+        }
+    }
+}
+
+static void benchDecode(const BenchOptions &options) {
+    uint16_t words[16];
+    uint16_t mixedWords[16];
+    for (int c = 0; c < 8; c++) {
+        encodeValue(FORMAT_FLOAT_ABCD, 20.0f + c, 1.0f, words + c * 2);
+        encodeValue(BENCH_CHANNELS[c].format, 20.0f + c, BENCH_CHANNELS[c].scale, mixedWords + c * 2);
+    }
+    float values[8];
+
+    SensorChannel uniform[8];
+    for (int c = 0; c < 8; c++) {
+        uniform[c] = BENCH_CHANNELS[0];
+        uniform[c].registerAddress = 0x30 + c * 2;
+    }
+
+    runBenchmark("decode/float_abcd x8", options.iterations, [&](uint32_t) {
+        decodeChannelBlock(uniform, 8, 0x30, words, values);
+        benchSink += (uint32_t)values[7];
+    });
+
+    runBenchmark("decode/mixed_formats x8", options.iterations, [&](uint32_t) {
+        decodeChannelBlock(BENCH_CHANNELS, 8, 0x30, mixedWords, values);
+        benchSink += (uint32_t)values[7];
+    });
+}
+
+static void benchFormat(const BenchOptions &options) {
+    char text[8];
+    runBenchmark("format/formatDeci", options.iterations, [&](uint32_t i) {
+        benchSink += formatDeci((int16_t)(i % 6000) - 2000, text);
+    });
+}
+
+static void benchFilter(const BenchOptions &options) {
+    ChannelFilter filter;
+    filter.configure({3, 2});
+    runBenchmark("filter/median3_ema2", options.iterations, [&](uint32_t i) {
+        benchSink += filter.apply(2000 + (int16_t)(i % 17));
+    });
+
+    // 1 h window, one value per second
+    WindowAggregate aggregate;
+    aggregate.begin(3600000);
+    runBenchmark("filter/window_add", options.iterations, [&](uint32_t i) {
+        aggregate.add(i * 1000, 2000 + (int16_t)(i % 17));
+    });
+    runBenchmark("filter/window_stats", options.iterations, [&](uint32_t i) {
+        benchSink += aggregate.stats(options.iterations * 1000 + i).count;
+    }, "12 buckets");
+}
+
+static void benchAlarm(const BenchOptions &options) {
+    // Two threshold rules per channel and one rate rule on every second one
+    static CompiledAlarm alarms[BENCH_SENSORS * 2 + BENCH_SENSORS / 2];
+    int count = 0;
+    for (int c = 0; c < BENCH_SENSORS; c++) {
+        alarms[count++] = compileAlarmRule({(uint8_t)c, ALARM_HIGH, 90.0f, 2.0f, -1, "High"});
+        alarms[count++] = compileAlarmRule({(uint8_t)c, ALARM_LOW, 3.0f, 1.0f, -1, "Low"});
+        if (c % 2 == 0) {
+            alarms[count++] = compileAlarmRule({(uint8_t)c, ALARM_RISE, 5.0f, 1.0f, -1, "Rise"});
+        }
+    }
+
+    AlarmEngine engine;
+    engine.begin(alarms, count, 30000);
+    char note[32];
+    snprintf(note, sizeof(note), "%d rules", count);
+    runBenchmark("alarm/evaluate", options.iterations, [&](uint32_t i) {
+        benchSink += engine.evaluate(i % BENCH_SENSORS, 2000 + (int16_t)(i % 9000), i * 100);
+    }, note);
+}
+
+static void benchRender(const BenchOptions &options, const BenchSample &sample, const char *const *names) {
+    static BenchJson json;
+    runBenchmark("render/sensordata_json", options.iterations / 10, [&](uint32_t) {
+        json.length = renderSensorDataJson(sample.readings, names, BENCH_SENSORS, sample.timestamp,
+                                           json.payload, sizeof(json.payload));
+        benchSink += json.length;
+    });
+
+    char note[48];
+    snprintf(note, sizeof(note), "%u bytes, %d sensors", json.length, BENCH_SENSORS);
+    printf("%-28s %s\n", "", note);
+
+    uint8_t binary[SENSOR_BINARY_SIZE(BENCH_MAX_SENSORS)];
+    size_t binaryLength = 0;
+    runBenchmark("render/sensordata_bin", options.iterations / 10, [&](uint32_t i) {
+        binaryLength = renderSensorDataBinary(sample.readings, BENCH_SENSORS, sample.timestamp, i,
+                                              binary, sizeof(binary));
+        benchSink += binaryLength;
+    });
+
+    snprintf(note, sizeof(note), "%zu bytes, %d sensors", binaryLength, BENCH_SENSORS);
+    printf("%-28s %s\n", "", note);
+}
+
+/**
+ * @brief Sample-to-publish pipeline of the acquisition task
+ *
+ * Every cycle reads all devices from the simulated bus, decodes,
+ * converts and filters the values, publishes the sample snapshot and
+ * refreshes the JSON cache, like acquisitionTask() does on the device.
+ * The bus side is the firmware's ModbusAcquisition. One cycle stands
+ * for one second; a device whose LinkHealth is not due is skipped, so a
+ * dead device costs a timeout per probe only.
+ */
+static void benchPipeline(const BenchOptions &options, const char *const *names) {
+    SimulatedBus bus(options.bus);
+    for (int d = 0; d < (int)(sizeof(BENCH_DEVICES) / sizeof(BENCH_DEVICES[0])); d++) {
+        const BenchDevice &device = BENCH_DEVICES[d];
+        if (d != options.deadDevice) {
+            bus.addSlave(device.slaveId, device.registerType, device.firstRegister, device.registerCount);
+        }
+    }
+
+    static SnapshotBuffer<BenchSample> readings;
+    static SnapshotBuffer<BenchJson> jsonCache;
+    static BenchSample sample;
+    static BenchJson json;
+    static ChannelFilter filters[BENCH_MAX_SENSORS];
+    static WindowAggregate aggregates[BENCH_MAX_SENSORS];
+    static DeviceLink links[sizeof(BENCH_DEVICES) / sizeof(BENCH_DEVICES[0])];
+    static LinkHealth channelHealth[BENCH_MAX_SENSORS];
+    ModbusAcquisition acquisition(bus, BENCH_LINK_POLICY, BENCH_RETRIES);
+    memset(&sample, 0, sizeof(sample));
+    for (DeviceLink &link : links) {
+        link.blockRead = true;
+    }
+    for (int i = 0; i < BENCH_SENSORS; i++) {
+        filters[i].configure({3, 2});
+        aggregates[i].begin(3600000);
+    }
+
+    uint32_t cycles = options.iterations / 10;
+    double cpuNs = 0;
+
+    for (uint32_t cycle = 0; cycle < cycles; cycle++) {
+        loadRegisters(bus, cycle);
+        sample.timestamp = cycle * 1000 + 1;
+
+        BenchClock::time_point start = BenchClock::now();
+        for (int d = 0; d < (int)(sizeof(BENCH_DEVICES) / sizeof(BENCH_DEVICES[0])); d++) {
+            const BenchDevice &device = BENCH_DEVICES[d];
+            if (!links[d].health.due(sample.timestamp)) {
+                continue;
+            }
+            const AcquisitionDevice target = {device.slaveId, device.registerType,
+                                              &BENCH_CHANNELS[device.firstChannel], device.channels,
+                                              device.firstRegister, device.registerCount};
+            float values[BENCH_MAX_SENSORS] = {};
+            bool valid[BENCH_MAX_SENSORS];
+            acquisition.poll(target, links[d], &channelHealth[device.firstChannel], sample.timestamp, 1000,
+                             values, valid);
+            for (int i = 0; i < device.channels; i++) {
+                int channel = device.firstChannel + i;
+                SensorReading &reading = sample.readings[channel];
+                updateReading(reading, valid[i], values[i], 0, sample.timestamp, 3000);
+                if (reading.quality & QUALITY_OK) {
+                    reading.centi = filters[channel].apply(reading.centi);
+                    aggregates[channel].add(sample.timestamp, reading.centi);
+                }
+            }
+        }
+        readings.publish(sample);
+
+        memset(&json, 0, sizeof(json));
+        json.length = renderSensorDataJson(sample.readings, names, BENCH_SENSORS, sample.timestamp,
+                                           json.payload, sizeof(json.payload));
+        jsonCache.publishIfChanged(json);
+        cpuNs += elapsedNs(start);
+    }
+
+    double cpuPerCycle = cpuNs / cycles;
+    double busPerCycle = (double)bus.busTimeUs() * 1000.0 / cycles;
+
+    char note[80];
+    snprintf(note, sizeof(note), "%u requests, %u failed, %u retries", bus.requests(), bus.failures(),
+             acquisition.retries());
+    printResult("pipeline/cpu per cycle", cpuPerCycle, note);
+    printf("%-28s %12.3f ms bus time per cycle at %u baud\n", "pipeline/bus (modelled)",
+           busPerCycle / 1e6, options.bus.baud);
+    printf("%-28s %12.3f ms sample-to-publish\n", "pipeline/latency", (busPerCycle + cpuPerCycle) / 1e6);
+}
+
+static void parseOptions(int argc, char **argv, BenchOptions &options) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = strchr(arg, '=');
+        if (value == nullptr) {
+            continue;
+        }
+        value++;
+
+        if (strncmp(arg, "iterations=", 11) == 0) {
+            options.iterations = strtoul(value, nullptr, 10);
+        } else if (strncmp(arg, "baud=", 5) == 0) {
+            options.bus.baud = strtoul(value, nullptr, 10);
+        } else if (strncmp(arg, "latency=", 8) == 0) {
+            options.bus.responseLatencyUs = strtoul(value, nullptr, 10);
+        } else if (strncmp(arg, "timeouts=", 9) == 0) {
+            options.bus.timeoutRate = strtof(value, nullptr);
+        } else if (strncmp(arg, "crc=", 4) == 0) {
+            options.bus.crcErrorRate = strtof(value, nullptr);
+        } else if (strncmp(arg, "max_registers=", 14) == 0) {
+            options.bus.maxRegisters = strtoul(value, nullptr, 10);
+        } else if (strncmp(arg, "dead=", 5) == 0) {
+            options.deadDevice = atoi(value);
+        } else {
+            fprintf(stderr, "Unknown option %s\n", arg);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+    options.iterations = 200000;
+    options.bus.baud = 9600;
+    options.bus.responseLatencyUs = 5000;
+    options.bus.timeoutUs = 2000000;
+    options.bus.timeoutRate = 0;
+    options.bus.crcErrorRate = 0;
+    options.bus.maxRegisters = 0;
+    options.deadDevice = -1;
+    parseOptions(argc, argv, options);
+
+    if (options.iterations < 10 || options.bus.baud == 0) {
+        fprintf(stderr, "iterations must be >= 10 and baud > 0\n");
+        return 1;
+    }
+
+    const char *names[BENCH_MAX_SENSORS];
+    for (int i = 0; i < BENCH_SENSORS; i++) {
+        names[i] = BENCH_CHANNELS[i].label;
+    }
+
+    // Representative sample: mostly good values, one stale, one failed
+    BenchSample sample;
+    memset(&sample, 0, sizeof(sample));
+    sample.timestamp = 60000;
+    for (int i = 0; i < BENCH_SENSORS; i++) {
+        sample.readings[i].centi = 2000 + i * 250;
+        sample.readings[i].quality = QUALITY_OK;
+        sample.readings[i].lastGood = sample.timestamp;
+    }
+    sample.readings[3].quality = QUALITY_COMM_ERROR | QUALITY_STALE;
+    sample.readings[3].lastGood = 58000;
+    sample.readings[5].quality = QUALITY_OUT_OF_RANGE;
+
+    printf("Thermohub8 native benchmark (%u iterations)\n\n", options.iterations);
+    benchDecode(options);
+    benchFormat(options);
+    benchFilter(options);
+    benchAlarm(options);
+    benchRender(options, sample, names);
+    benchPipeline(options, names);
+    return 0;
+}
@@ -4,9 +4,9 @@ from homeassistant.config_entries import ConfigEntry
 from homeassistant.core import HomeAssistant
 from homeassistant.helpers.aiohttp_client import async_get_clientsession
 
-from .const import DOMAIN, PLATFORMS, CONF_BASE_URL, CONF_API_KEY, CONF_VERIFY_SSL, CONF_SCAN_INTERVAL
+from .const import DOMAIN, PLATFORMS, CONF_BASE_URL, CONF_API_KEY, CONF_VERIFY_SSL, CONF_SCAN_INTERVAL, CONF_PUSH, DEFAULT_PUSH, CONF_BINARY, DEFAULT_BINARY, DATA_POLLER
 from .api import ThermoHub8Client
-from .coordinator import ThermoHub8Coordinator
+from .coordinator import ThermoHub8Coordinator, ThermoHub8Poller
 
 import logging
 _LOGGER = logging.getLogger(__name__)
@@ -21,11 +21,20 @@ async def async_setup_entry(hass: HomeAssistant, entry: ThermoHub8ConfigEntry) -
     api_key: str | None = entry.data.get(CONF_API_KEY)
     verify_ssl: bool = entry.data.get(CONF_VERIFY_SSL, True)
     scan_interval: int | None = entry.options.get(CONF_SCAN_INTERVAL) if entry.options else None
+    push: bool = entry.options.get(CONF_PUSH, DEFAULT_PUSH) if entry.options else DEFAULT_PUSH
+    binary: bool = entry.options.get(CONF_BINARY, DEFAULT_BINARY) if entry.options else DEFAULT_BINARY
     _LOGGER.info("Setting up ThermoHub8 for %s", entry.data.get("base_url"))
     client = ThermoHub8Client(session=session, base_url=base_url, api_key=api_key, verify_ssl=verify_ssl)
-    coordinator = ThermoHub8Coordinator(hass, client, scan_interval)
+    coordinator = ThermoHub8Coordinator(hass, client, scan_interval, push, binary)
     await coordinator.async_config_entry_first_refresh()
     _LOGGER.info("ThermoHub8 initial refresh complete")
+    if push:
+        # Wird beim Entladen des Eintrags automatisch beendet
+        entry.async_create_background_task(hass, coordinator.async_stream_loop(), f"{DOMAIN}_stream_{entry.entry_id}")
+    else:
+        # Ein gemeinsamer Poller für alle Hubs
+        poller: ThermoHub8Poller = hass.data.setdefault(DATA_POLLER, ThermoHub8Poller(hass))
+        poller.async_add(coordinator)
     hass.data.setdefault(DOMAIN, {})
     hass.data[DOMAIN][entry.entry_id] = {
         "client": client,
@@ -42,7 +51,10 @@ async def async_unload_entry(hass: HomeAssistant, entry: ThermoHub8ConfigEntry)
     unload_ok = await hass.config_entries.async_unload_platforms(entry, PLATFORMS)
     if unload_ok:
         _LOGGER.debug("ThermoHub8 entry %s unloaded successfully", entry.entry_id)        
-        hass.data.get(DOMAIN, {}).pop(entry.entry_id, None)
+        data = hass.data.get(DOMAIN, {}).pop(entry.entry_id, None)
+        poller: ThermoHub8Poller | None = hass.data.get(DATA_POLLER)
+        if data and poller and poller.async_remove(data["coordinator"]):
+            hass.data.pop(DATA_POLLER, None)
     else:
         _LOGGER.warning("ThermoHub8 entry %s failed to unload", entry.entry_id)        
     return unload_ok
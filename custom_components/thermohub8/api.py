@@ -1,25 +1,42 @@
 from __future__ import annotations
 
-from typing import Any, Dict, List, Optional
+from datetime import datetime, timezone
+from typing import Any, AsyncIterator, Dict, List, Optional, Tuple
 import asyncio
+import json
+import struct
 import yarl
 import logging
-from aiohttp import ClientSession, ClientResponseError
+from aiohttp import ClientSession, ClientResponseError, ClientTimeout
+
+from .const import REQUEST_TIMEOUT
 
 _LOGGER = logging.getLogger(__name__)
 
+# Binärformat von /api/v1/sensordata.bin (little endian, siehe esp32/SensorRender.h)
+BINARY_VERSION = 1
+BINARY_HEADER = struct.Struct("<BBBBII")  # version, count, entry_size, reserviert, timestamp (ms), unix_time
+BINARY_ENTRY = struct.Struct("<BBh")      # id, quality, value (0.01 °C)
+BINARY_NO_VALUE = -32768
+
+# Qualitätsbits wie in der Firmware (SensorCore.h), in der Reihenfolge von qualityName()
+QUALITY_NAMES = ((0x01, "ok"), (0x02, "stale"), (0x04, "comm_error"), (0x08, "out_of_range"))
+
 
 class ThermoHub8Client:
     """
     Minimaler REST-Client für ThermoHub8.
-    Erwartet JSON wie:
+    Erwartet JSON von /api/v1/sensordata wie:
     {
       "sensors": [
-        {"id": 1, "name": "Sensor 1", "value": 21.3, "unit": "°C"},
+        {"id": 0, "name": "Sensor 1", "value": 21.3, "unit": "°C", "status": "ok"},
         ...
       ],
       "ts": "2025-09-15T12:34:56Z"
     }
+    Die Verbindungen kommen aus dem gemeinsamen Session-Pool von Home Assistant.
+    Pro Endpunkt wird das letzte ETag gemerkt; bedingte Abfragen (If-None-Match)
+    liefern None, solange die Firmware 304 Not Modified antwortet.
     """
 
     def __init__(self, session: ClientSession, base_url: str, api_key: Optional[str] = None, verify_ssl: bool = True) -> None:
@@ -27,33 +44,134 @@ class ThermoHub8Client:
         self._base_url = str(yarl.URL(base_url).with_scheme(yarl.URL(base_url).scheme or "http"))
         self._api_key = api_key
         self._ssl = verify_ssl
+        self._timeout = ClientTimeout(total=REQUEST_TIMEOUT)
+        self._etags: Dict[str, str] = {}
 
         _LOGGER.debug("ThermoHub8Client initialized base_url=%s verify_ssl=%s", self._base_url, verify_ssl)
 
-    async def async_get_readings(self) -> Dict[str, Any]:
-        url = str(yarl.URL(self._base_url) / "api" / "v1" / "readings")
+    async def _async_fetch(self, endpoint: str, conditional: bool) -> Optional[bytes]:
+        """GET auf /api/v1/<endpoint>; None bei 304 (nur mit conditional=True möglich)."""
+        url = str(yarl.URL(self._base_url) / "api" / "v1" / endpoint)
         headers = {}
         if self._api_key:
             headers["Authorization"] = f"Bearer {self._api_key}"
-
-        _LOGGER.debug("Requesting ThermoHub8 readings from %s", url)
+        etag = self._etags.get(endpoint) if conditional else None
+        if etag:
+            headers["If-None-Match"] = etag
 
         try:
-            async with self._session.get(url, headers=headers, ssl=self._ssl, timeout=10) as resp:
+            async with self._session.get(url, headers=headers, ssl=self._ssl, timeout=self._timeout) as resp:
+                if resp.status == 304 and etag:
+                    return None
                 resp.raise_for_status()
-                data = await resp.json()
-                _LOGGER.debug("Received ThermoHub8 payload: %s", data)
-                return data
+                body = await resp.read()
+                if "ETag" in resp.headers:
+                    self._etags[endpoint] = resp.headers["ETag"]
+                return body
         except ClientResponseError as e:
             _LOGGER.warning("ThermoHub8 API error (%s): %s", e.status, e.message)
             raise ConnectionError(f"ThermoHub8 API error: {e.status} {e.message}") from e
         except asyncio.TimeoutError:
-            _LOGGER.error("ThermoHub8 API timeout after 10s")
+            _LOGGER.error("ThermoHub8 API timeout after %ss", REQUEST_TIMEOUT)
             raise
 
+    async def async_get_readings(self, conditional: bool = False) -> Optional[Dict[str, Any]]:
+        """
+        Liest /api/v1/sensordata. Mit conditional=True None, wenn sich seit der
+        letzten Antwort nichts geändert hat.
+        """
+        _LOGGER.debug("Requesting ThermoHub8 readings from %s", self._base_url)
+        body = await self._async_fetch("sensordata", conditional)
+        if body is None:
+            return None
+        data = json.loads(body)
+        _LOGGER.debug("Received ThermoHub8 payload: %s", data)
+        return data
+
+    async def async_get_readings_binary(self, conditional: bool = False) -> Optional[Dict[str, Any]]:
+        """
+        Liest /api/v1/sensordata.bin und liefert es in der Form des JSON-Payloads.
+        Namen sind nicht enthalten; sie kommen per merge_payload() aus dem letzten JSON.
+        Mit conditional=True None, solange kein neuer Messzyklus vorliegt.
+        """
+        body = await self._async_fetch("sensordata.bin", conditional)
+        return None if body is None else self.decode_binary(body)
+
+    @staticmethod
+    def decode_binary(data: bytes) -> Dict[str, Any]:
+        """Binären Payload dekodieren: {"sensors": [{"id", "value", "unit", "status"}], "ts", "timestamp"}."""
+        if len(data) < BINARY_HEADER.size:
+            raise ValueError("ThermoHub8 binary payload too short")
+        version, count, entry_size, _, timestamp, unix_time = BINARY_HEADER.unpack_from(data)
+        if version != BINARY_VERSION or entry_size < BINARY_ENTRY.size or len(data) < BINARY_HEADER.size + count * entry_size:
+            raise ValueError(f"ThermoHub8 binary payload not supported (version {version})")
+
+        sensors: List[Dict[str, Any]] = []
+        for offset in range(BINARY_HEADER.size, BINARY_HEADER.size + count * entry_size, entry_size):
+            sensor_id, quality, value = BINARY_ENTRY.unpack_from(data, offset)
+            status = next((name for bit, name in QUALITY_NAMES if quality & bit), "no_data")
+            sensors.append(
+                {
+                    "id": sensor_id,
+                    "value": None if value == BINARY_NO_VALUE else value / 100,
+                    "unit": "°C",
+                    "status": status,
+                }
+            )
+
+        payload: Dict[str, Any] = {"sensors": sensors, "timestamp": timestamp}
+        if unix_time:
+            payload["ts"] = datetime.fromtimestamp(unix_time, timezone.utc).isoformat().replace("+00:00", "Z")
+        return payload
+
+    async def async_stream_readings(self) -> AsyncIterator[Tuple[str, Dict[str, Any]]]:
+        """
+        Abonniert /api/v1/stream (Server-Sent Events) und liefert (event, data).
+        Das erste Event enthält den vollständigen Zustand, danach nur geänderte Sensoren.
+        """
+        url = str(yarl.URL(self._base_url) / "api" / "v1" / "stream")
+        headers = {"Accept": "text/event-stream"}
+        if self._api_key:
+            headers["Authorization"] = f"Bearer {self._api_key}"
+
+        _LOGGER.debug("Subscribing to ThermoHub8 stream at %s", url)
+
+        # Kein Gesamt-Timeout, aber Verbindungsabbruch erkennen
+        timeout = ClientTimeout(total=None, connect=10, sock_read=60)
+        async with self._session.get(url, headers=headers, ssl=self._ssl, timeout=timeout) as resp:
+            resp.raise_for_status()
+            event = "message"
+            data_lines: List[str] = []
+            async for raw in resp.content:
+                line = raw.decode("utf-8").rstrip("\r\n")
+                if not line:
+                    # Leerzeile beendet ein Event
+                    if data_lines:
+                        try:
+                            yield event, json.loads("\n".join(data_lines))
+                        except ValueError:
+                            _LOGGER.warning("ThermoHub8 stream: invalid event data")
+                    event = "message"
+                    data_lines = []
+                elif line.startswith("event:"):
+                    event = line[6:].strip()
+                elif line.startswith("data:"):
+                    data_lines.append(line[5:].lstrip())
+                # "id:", "retry:" und Kommentare werden ignoriert
+
+    @staticmethod
+    def merge_payload(payload: Dict[str, Any], update: Dict[str, Any]) -> Dict[str, Any]:
+        """Teil-Update (Stream oder Binär-Payload) in den letzten vollständigen Payload einarbeiten."""
+        sensors = {item.get("id"): dict(item) for item in payload.get("sensors") or []}
+        for item in update.get("sensors") or []:
+            sensors.setdefault(item.get("id"), {}).update(item)
+        merged = dict(payload)
+        merged.update({key: value for key, value in update.items() if key != "sensors"})
+        merged["sensors"] = [sensors[key] for key in sorted(sensors, key=lambda k: (k is None, k))]
+        return merged
+
     @staticmethod
     def normalize_payload(payload: Dict[str, Any]) -> List[Dict[str, Any]]:
-        _LOGGER.debug("Normalizing ThermoHub8 payload")
         sensors = payload.get("sensors") or []
         normalized: List[Dict[str, Any]] = []
         for idx, item in enumerate(sensors, start=1):
@@ -69,5 +187,4 @@ class ThermoHub8Client:
                     "unit": unit,
                 }
             )
-            _LOGGER.debug("Normalized sensor %s: name=%s value=%s unit=%s", sensor_id, name, value, unit)
         return normalized
@@ -16,8 +16,12 @@ from .const import (
     CONF_API_KEY,
     CONF_VERIFY_SSL,
     CONF_SCAN_INTERVAL,
+    CONF_PUSH,
+    CONF_BINARY,
     DEFAULT_VERIFY_SSL,
     DEFAULT_SCAN_INTERVAL,
+    DEFAULT_PUSH,
+    DEFAULT_BINARY,
 )
 from .api import ThermoHub8Client
 
@@ -37,6 +41,8 @@ STEP_OPTIONS_DATA_SCHEMA = vol.Schema(
             CONF_SCAN_INTERVAL,
             default=DEFAULT_SCAN_INTERVAL
         ): vol.All(int, vol.Range(min=1, max=60)),
+        vol.Optional(CONF_PUSH, default=DEFAULT_PUSH): bool,
+        vol.Optional(CONF_BINARY, default=DEFAULT_BINARY): bool,
     }
 )
 
@@ -102,6 +108,8 @@ class OptionsFlowHandler(config_entries.OptionsFlow):
 
         current = {
             CONF_SCAN_INTERVAL: self._entry.options.get(CONF_SCAN_INTERVAL, DEFAULT_SCAN_INTERVAL),
+            CONF_PUSH: self._entry.options.get(CONF_PUSH, DEFAULT_PUSH),
+            CONF_BINARY: self._entry.options.get(CONF_BINARY, DEFAULT_BINARY),
         }
         return self.async_show_form(
             step_id="init",
@@ -110,7 +118,15 @@ class OptionsFlowHandler(config_entries.OptionsFlow):
                     vol.Required(
                         CONF_SCAN_INTERVAL,
                         default=current[CONF_SCAN_INTERVAL]
-                    ): vol.All(int, vol.Range(min=1, max=60))
+                    ): vol.All(int, vol.Range(min=1, max=60)),
+                    vol.Optional(
+                        CONF_PUSH,
+                        default=current[CONF_PUSH]
+                    ): bool,
+                    vol.Optional(
+                        CONF_BINARY,
+                        default=current[CONF_BINARY]
+                    ): bool,
                 }
             ),
         )
@@ -6,9 +6,18 @@ CONF_BASE_URL = "base_url"
 CONF_API_KEY = "api_key"
 CONF_VERIFY_SSL = "verify_ssl"
 CONF_SCAN_INTERVAL = "scan_interval"
+CONF_PUSH = "push"
+CONF_BINARY = "binary"
 
 DEFAULT_VERIFY_SSL = True
 DEFAULT_SCAN_INTERVAL = 5  # Sekunden – gerne anpassen
+DEFAULT_PUSH = False
+DEFAULT_BINARY = False
+STREAM_RECONNECT_DELAY = 5  # Sekunden bis zum erneuten Verbinden des Streams
+REQUEST_TIMEOUT = 5  # Sekunden pro Abfrage; ein toter Hub hält die anderen nicht auf
+POLL_JITTER = 0.5  # Sekunden zufälliger Versatz pro Abfrage (verteilt viele Hubs)
+POLL_CONCURRENCY = 8  # Gleichzeitige Abfragen aller Hubs zusammen
+DATA_POLLER = f"{DOMAIN}_poller"  # hass.data-Schlüssel des gemeinsamen Pollers
 MAX_SENSORS = 8
 
 PLATFORMS = ["sensor"]
@@ -1,43 +1,171 @@
 from __future__ import annotations
 
+import asyncio
+import random
 from datetime import timedelta
-from typing import Any, Dict, List
+from typing import Any, Callable, Dict, List, Optional
 
-from homeassistant.core import HomeAssistant
+from homeassistant.core import HomeAssistant, callback
+from homeassistant.helpers.event import async_track_time_interval
 from homeassistant.helpers.update_coordinator import DataUpdateCoordinator, UpdateFailed
 
 from .api import ThermoHub8Client
-from .const import DOMAIN, DEFAULT_SCAN_INTERVAL, CONF_SCAN_INTERVAL
+from .const import DOMAIN, DEFAULT_SCAN_INTERVAL, CONF_SCAN_INTERVAL, STREAM_RECONNECT_DELAY, POLL_JITTER, POLL_CONCURRENCY
 
 import logging
 _LOGGER = logging.getLogger(__name__)
 
 
 class ThermoHub8Coordinator(DataUpdateCoordinator[Dict[str, Any]]):
-    """Koordinator, der periodisch Messwerte lädt."""
+    """
+    Koordinator eines Hubs. Abgefragt wird er vom gemeinsamen ThermoHub8Poller
+    (oder im Push-Modus über den Stream), daher ohne eigenes update_interval.
+    """
     def __init__(
         self,
         hass: HomeAssistant,
         client: ThermoHub8Client,
         scan_interval: int | None,
+        push: bool = False,
+        binary: bool = False,
     ) -> None:
         super().__init__(
             hass,
             logger=_LOGGER,
             name=f"{DOMAIN}_coordinator",
-            update_interval=timedelta(seconds=scan_interval or DEFAULT_SCAN_INTERVAL),
+            update_interval=None,
         )
-        _LOGGER.info("ThermoHub8Coordinator created (interval=%ss)", (scan_interval or DEFAULT_SCAN_INTERVAL))
+        self.scan_interval = scan_interval or DEFAULT_SCAN_INTERVAL
+        _LOGGER.info("ThermoHub8Coordinator created (interval=%ss, push=%s, binary=%s)", self.scan_interval, push, binary)
         self.client = client
+        self.push = push
+        self.binary = binary
+        self._sensors: Dict[int, Dict[str, Any]] = {}
+        self._sensors_source: Optional[Dict[str, Any]] = None
+
+    @property
+    def sensors(self) -> Dict[int, Dict[str, Any]]:
+        """Normalisierte Sensoren nach ID; einmal pro neuem Payload berechnet."""
+        if self._sensors_source is not self.data:
+            self._sensors = {item["id"]: item for item in self.client.normalize_payload(self.data or {})}
+            self._sensors_source = self.data
+        return self._sensors
+
+    async def _async_fetch(self) -> Optional[Dict[str, Any]]:
+        """Neuen Payload laden; None, wenn die Firmware 304 (unverändert) meldet."""
+        if self.binary and self.data:
+            # Binär-Payload ohne Namen: in den ersten JSON-Payload einarbeiten
+            update = await self.client.async_get_readings_binary(conditional=True)
+            return None if update is None else self.client.merge_payload(self.data, update)
+        return await self.client.async_get_readings(conditional=self.data is not None)
 
     async def _async_update_data(self) -> Dict[str, Any]:
-        _LOGGER.debug("Coordinator update triggered")
+        """Erste Abfrage und manuelle Aktualisierung (async_request_refresh)."""
         try:
-            payload = await self.client.async_get_readings()
-            sensors = self.client.normalize_payload(payload)
-            _LOGGER.info("ThermoHub8 fetched %d sensor(s); ts=%s", len(sensors), payload.get("ts"))
+            payload = await self._async_fetch()
         except Exception as err:
             _LOGGER.error("ThermoHub8 update failed: %s", err)
-            raise
+            raise UpdateFailed(str(err)) from err
+        if payload is None:
+            return self.data
+        _LOGGER.debug("ThermoHub8 fetched %d sensor(s); ts=%s", len(payload.get("sensors") or []), payload.get("ts"))
         return payload
-    
\ No newline at end of file
+
+    async def async_poll(self) -> None:
+        """
+        Eine Abfrage durch den Poller. Bei 304 werden die Entitäten nicht geweckt,
+        es sei denn, der Hub war vorher nicht erreichbar.
+        """
+        try:
+            payload = await self._async_fetch()
+        except Exception as err:  # noqa: BLE001
+            if self.last_update_success:
+                _LOGGER.warning("ThermoHub8 update failed: %s", err)
+            self.async_set_update_error(err)
+            return
+        if payload is None:
+            if self.last_update_success:
+                return
+            payload = self.data
+        self.async_set_updated_data(payload)
+
+    async def async_stream_loop(self) -> None:
+        """
+        Push-Modus: Stream abonnieren und bei Abbruch neu verbinden. Solange der
+        Stream unterbrochen ist, gelten die Entitäten wie beim Polling als nicht
+        verfügbar; das erste Event nach dem Verbinden ersetzt die Daten vollständig.
+        """
+        while True:
+            try:
+                first = True
+                async for event, data in self.client.async_stream_readings():
+                    if event != "readings":
+                        continue
+                    payload = data if first else self.client.merge_payload(self.data or {}, data)
+                    first = False
+                    _LOGGER.debug("ThermoHub8 stream update: %s", data)
+                    self.async_set_updated_data(payload)
+                err: Exception = UpdateFailed("Stream closed by device")
+            except asyncio.CancelledError:
+                raise
+            except Exception as stream_err:  # noqa: BLE001
+                err = stream_err
+            if self.last_update_success:
+                _LOGGER.warning("ThermoHub8 stream failed: %s", err)
+            self.async_set_update_error(err)
+            await asyncio.sleep(STREAM_RECONNECT_DELAY)
+
+
+class ThermoHub8Poller:
+    """
+    Gemeinsamer Abfrage-Takt aller Hubs: ein Timer im Sekundentakt statt einem
+    pro Eintrag. Jeder Hub bekommt beim Anmelden eine zufällige Phase innerhalb
+    seines Intervalls und pro Abfrage einen kleinen Versatz, so verteilen sich
+    viele Hubs gleichmäßig. Fällige Hubs werden nebenläufig abgefragt (höchstens
+    POLL_CONCURRENCY gleichzeitig); ein Hub, dessen letzte Abfrage noch läuft,
+    wird übersprungen.
+    """
+    def __init__(self, hass: HomeAssistant) -> None:
+        self._hass = hass
+        self._hubs: Dict[ThermoHub8Coordinator, float] = {}  # Koordinator -> nächste Abfrage (loop.time())
+        self._running: set[ThermoHub8Coordinator] = set()
+        self._semaphore = asyncio.Semaphore(POLL_CONCURRENCY)
+        self._unsub: Optional[Callable[[], None]] = None
+
+    @callback
+    def async_add(self, coordinator: ThermoHub8Coordinator) -> None:
+        now = self._hass.loop.time()
+        self._hubs[coordinator] = now + random.uniform(0, coordinator.scan_interval)
+        if self._unsub is None:
+            self._unsub = async_track_time_interval(self._hass, self._async_tick, timedelta(seconds=1))
+        _LOGGER.debug("ThermoHub8 poller: %d hub(s)", len(self._hubs))
+
+    @callback
+    def async_remove(self, coordinator: ThermoHub8Coordinator) -> bool:
+        """Hub abmelden; True, wenn keiner mehr übrig ist (Timer gestoppt)."""
+        self._hubs.pop(coordinator, None)
+        if not self._hubs and self._unsub is not None:
+            self._unsub()
+            self._unsub = None
+        return not self._hubs
+
+    async def _async_tick(self, _now: Any) -> None:
+        now = self._hass.loop.time()
+        due: List[ThermoHub8Coordinator] = []
+        for coordinator, next_poll in self._hubs.items():
+            if next_poll <= now and coordinator not in self._running:
+                due.append(coordinator)
+                # Auf dem Raster bleiben, nach einem Hänger aber nicht nachholen
+                next_poll += coordinator.scan_interval
+                self._hubs[coordinator] = next_poll if next_poll > now else now + coordinator.scan_interval
+        if due:
+            await asyncio.gather(*(self._async_poll(coordinator) for coordinator in due))
+
+    async def _async_poll(self, coordinator: ThermoHub8Coordinator) -> None:
+        self._running.add(coordinator)
+        try:
+            await asyncio.sleep(random.uniform(0, POLL_JITTER))
+            async with self._semaphore:
+                await coordinator.async_poll()
+        finally:
+            self._running.discard(coordinator)
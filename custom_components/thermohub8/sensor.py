@@ -3,14 +3,13 @@ from __future__ import annotations
 from typing import Any, Dict, List, Optional
 
 from homeassistant.components.sensor import SensorEntity, SensorDeviceClass, SensorStateClass
-from homeassistant.core import HomeAssistant
+from homeassistant.core import HomeAssistant, callback
 from homeassistant.helpers.entity_platform import AddEntitiesCallback
 from homeassistant.helpers.update_coordinator import CoordinatorEntity
 
 from homeassistant.config_entries import ConfigEntry
 from .const import DOMAIN, MAX_SENSORS, ATTR_LAST_UPDATE
 from .coordinator import ThermoHub8Coordinator
-from .api import ThermoHub8Client
 
 import logging
 _LOGGER = logging.getLogger(__name__)
@@ -20,8 +19,7 @@ async def async_setup_entry(hass: HomeAssistant, entry: ConfigEntry, async_add_e
     coordinator: ThermoHub8Coordinator = data["coordinator"]
 
     # Erzeuge Entitäten dynamisch basierend auf der ersten Aktualisierung
-    payload = coordinator.data or {}
-    normalized = ThermoHub8Client.normalize_payload(payload)
+    normalized = list(coordinator.sensors.values())
 
     _LOGGER.info("ThermoHub8 creating up to %d sensor entities", MAX_SENSORS)
     _LOGGER.debug("Initial normalized sensors: %s", [s.get("name") for s in normalized])
@@ -71,6 +69,7 @@ class ThermoHub8Sensor(CoordinatorEntity[ThermoHub8Coordinator], SensorEntity):
         self._attr_name = name
         self._unit = unit
         self._optional = optional
+        self._written_state: Optional[tuple] = None
 
         _LOGGER.debug("ThermoHub8Sensor created: id=%s name=%s unit=%s optional=%s",
                       sensor_id, name, unit, optional)
@@ -91,15 +90,22 @@ class ThermoHub8Sensor(CoordinatorEntity[ThermoHub8Coordinator], SensorEntity):
     def native_unit_of_measurement(self) -> str | None:
         return self._unit
 
+    @callback
+    def _handle_coordinator_update(self) -> None:
+        # Zustand nur schreiben, wenn sich Wert, Verfügbarkeit oder Attribute geändert haben;
+        # bei vielen Hubs bleibt so die Last der Zustandsänderungen gering
+        state = (self.available, self.native_value, self.extra_state_attributes)
+        if state == self._written_state:
+            return
+        self._written_state = state
+        self.async_write_ha_state()
+
     @property
     def available(self) -> bool:
         # verfügbar wenn Coordinator OK und dieser Sensor im Payload auftaucht
         if not super().available:
             return False
-        normalized = ThermoHub8Client.normalize_payload(self.coordinator.data or {})
-        ok = any(item.get("id") == self._sensor_id for item in normalized) or self._optional
-        _LOGGER.debug("Sensor %s available=%s", self._sensor_id, ok)
-        return ok
+        return self._sensor_id in self.coordinator.sensors or self._optional
         
     @property
     def extra_state_attributes(self) -> Dict[str, Any] | None:
@@ -108,12 +114,7 @@ class ThermoHub8Sensor(CoordinatorEntity[ThermoHub8Coordinator], SensorEntity):
 
     @property
     def native_value(self) -> Any:
-        normalized = ThermoHub8Client.normalize_payload(self.coordinator.data or {})
-        for item in normalized:
-            if item.get("id") == self._sensor_id:
-                value = item.get("value")
-                _LOGGER.debug("Sensor %s (%s) value=%s", self._sensor_id, self.name, value)
-                return value
+        item = self.coordinator.sensors.get(self._sensor_id)
         # wenn optionaler Sensor, aber (noch) nicht vorhanden
-        return None
+        return item.get("value") if item else None
 
@@ -0,0 +1,156 @@
+/**
+ * @file AlarmEngine.cpp
+ * @brief Threshold and rate-of-change alarms with hysteresis
+ *
+ * The rules are compiled into fixed-point thresholds at build time
+ * (compileAlarmRule()); evaluating a new value walks the flat table
+ * once and compares integers, so it can run right after every sample
+ * on the acquisition path. A rule switches on at its threshold and
+ * off only after the value moved back by the hysteresis, so a value
+ * hovering around the threshold does not toggle the outputs.
+ *
+ * Rates are measured against a value between rateWindow and twice
+ * rateWindow old, which keeps the noise of single readings out of the
+ * rate while still reacting on every sample.
+ *
+ * Like SensorCore, nothing here touches Arduino or FreeRTOS, so the
+ * same code runs in the native benchmark build (bench/).
+ *
+ * @author Johannes
+ * @version 1.0
+ * @date 2025
+ */
+
+#include "AlarmEngine.h"
+#include <string.h>
+
+/**
+ * @brief Constructor - No rules until begin()
+ */
+AlarmEngine::AlarmEngine() {
+    _alarms = nullptr;
+    _count = 0;
+    _rateWindow = 1;
+    _active = 0;
+    _transitions = 0;
+    memset(_since, 0, sizeof(_since));
+    memset(_rates, 0, sizeof(_rates));
+}
+
+/**
+ * @brief Take over the compiled rule table
+ *
+ * @param alarms Compiled rules (referenced, not copied)
+ * @param count Number of rules (at most ALARM_MAX_RULES)
+ * @param rateWindow Minimum age of the reference value for rates in ms
+ * @return false if there are too many rules or a sensor is out of range
+ */
+bool AlarmEngine::begin(const CompiledAlarm *alarms, uint8_t count, uint32_t rateWindow) {
+    if (count > ALARM_MAX_RULES) {
+        return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        if (alarms[i].sensor >= ALARM_MAX_SENSORS) {
+            return false;
+        }
+    }
+
+    _alarms = alarms;
+    _count = count;
+    _rateWindow = rateWindow > 0 ? rateWindow : 1;
+    _active = 0;
+    _transitions = 0;
+    memset(_since, 0, sizeof(_since));
+    memset(_rates, 0, sizeof(_rates));
+    return true;
+}
+
+/**
+ * @brief Track the reference values of a sensor and compute its rate
+ *
+ * @param rate Set to the change in 0.01 °C per minute
+ * @return false while there is no reference value rateWindow old yet
+ */
+bool AlarmEngine::updateRate(uint8_t sensor, int16_t centi, uint32_t now, int32_t &rate) {
+    RateState &state = _rates[sensor];
+
+    if (state.points == 0) {
+        state.anchor = centi;
+        state.anchorTime = now;
+        state.points = 1;
+    } else if (now - state.anchorTime >= _rateWindow) {
+        state.base = state.anchor;
+        state.baseTime = state.anchorTime;
+        state.anchor = centi;
+        state.anchorTime = now;
+        state.points = 2;
+    }
+
+    if (state.points < 2 || now == state.baseTime) {
+        return false;
+    }
+    rate = (int32_t)((int64_t)(centi - state.base) * 60000 / (int32_t)(now - state.baseTime));
+    return true;
+}
+
+/**
+ * @brief Evaluate all rules of a sensor against its new value
+ *
+ * Rules of rate type stay unchanged until a rate is available. The
+ * caller only passes current readings; rules of a sensor without a
+ * current reading keep their state.
+ *
+ * @param sensor Sensor index
+ * @param centi New value in 0.01 °C
+ * @param now Sample time in ms (millis())
+ * @return true if at least one rule switched on or off
+ */
+bool AlarmEngine::evaluate(uint8_t sensor, int16_t centi, uint32_t now) {
+    if (sensor >= ALARM_MAX_SENSORS) {
+        return false;
+    }
+
+    int32_t rate = 0;
+    bool hasRate = updateRate(sensor, centi, now, rate);
+    uint32_t before = _active;
+
+    for (uint8_t i = 0; i < _count; i++) {
+        const CompiledAlarm &alarm = _alarms[i];
+        if (alarm.sensor != sensor || (alarm.rate && !hasRate)) {
+            continue;
+        }
+
+        int32_t x = alarm.rate ? rate : centi;
+        uint32_t bit = 1UL << i;
+        bool active = _active & bit;
+        if (!active) {
+            active = alarm.upper ? x >= alarm.set : x <= alarm.set;
+        } else {
+            active = alarm.upper ? x >= alarm.clear : x <= alarm.clear;
+        }
+
+        if (active != (bool)(_active & bit)) {
+            _active ^= bit;
+            _since[i] = now;
+            _transitions++;
+        }
+    }
+
+    return _active != before;
+}
+
+uint8_t AlarmEngine::count() const {
+    return _count;
+}
+
+uint32_t AlarmEngine::activeMask() const {
+    return _active;
+}
+
+uint32_t AlarmEngine::since(uint8_t alarm) const {
+    return alarm < ALARM_MAX_RULES ? _since[alarm] : 0;
+}
+
+uint32_t AlarmEngine::transitions() const {
+    return _transitions;
+}
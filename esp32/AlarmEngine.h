@@ -0,0 +1,101 @@
+#ifndef ALARM_ENGINE_H
+#define ALARM_ENGINE_H
+
+// Grenzwertüberwachung pro Kanal mit Hysterese (auch nativ übersetzbar)
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Maximale Anzahl Regeln (Bitmaske in uint32_t)
+#define ALARM_MAX_RULES 32
+
+// Maximale Anzahl Kanäle
+#define ALARM_MAX_SENSORS 32
+
+// Art einer Regel
+enum AlarmType : uint8_t {
+    ALARM_HIGH, // Wert >= Schwelle
+    ALARM_LOW,  // Wert <= Schwelle
+    ALARM_RISE, // Anstieg >= Schwelle (°C/min)
+    ALARM_FALL, // Abfall >= Schwelle (°C/min, Betrag)
+    ALARM_TYPE_COUNT
+};
+
+// Regel der Konfiguration (°C bzw. °C/min)
+struct AlarmRule {
+    uint8_t sensor;    // Kanal (Index in der Kanaltabelle)
+    AlarmType type;
+    float threshold;   // Auslöseschwelle
+    float hysteresis;  // Abstand zur Rücksetzschwelle (>= 0)
+    int8_t output;     // GPIO, der während des Alarms aktiv ist (-1 = keiner)
+    const char *label; // Text für LCD, API und MQTT
+};
+
+// Übersetzte Regel in Festkomma (0.01 °C bzw. 0.01 °C/min)
+// Obere Regeln (HIGH, RISE): aktiv ab x >= set, inaktiv ab x < clear
+// Untere Regeln (LOW, FALL): aktiv ab x <= set, inaktiv ab x > clear
+struct CompiledAlarm {
+    uint8_t sensor;
+    bool upper;  // Obere Regel
+    bool rate;   // Prüft die Änderungsrate statt des Werts
+    int16_t set;
+    int16_t clear;
+    int8_t output;
+};
+
+// °C -> 0.01 °C, gerundet
+constexpr int16_t alarmCenti(float value) {
+    return (int16_t)(value >= 0 ? value * 100 + 0.5f : value * 100 - 0.5f);
+}
+
+// Regel zur Übersetzungszeit in Festkomma umrechnen
+constexpr CompiledAlarm compileAlarmRule(const AlarmRule &rule) {
+    bool upper = (rule.type == ALARM_HIGH || rule.type == ALARM_RISE);
+    int16_t set = alarmCenti(rule.type == ALARM_FALL ? -rule.threshold : rule.threshold);
+    int16_t hysteresis = alarmCenti(rule.hysteresis);
+    return CompiledAlarm{rule.sensor, upper, rule.type == ALARM_RISE || rule.type == ALARM_FALL, set,
+                         (int16_t)(upper ? set - hysteresis : set + hysteresis), rule.output};
+}
+
+class AlarmEngine {
+public:
+    // Konstruktor (keine Regeln)
+    AlarmEngine();
+
+    // Übersetzte Regeln übernehmen, alle inaktiv (Tabelle muss bestehen bleiben)
+    // rateWindow: Mindestabstand der Vergleichswerte für die Änderungsrate in ms
+    bool begin(const CompiledAlarm *alarms, uint8_t count, uint32_t rateWindow);
+
+    // Neuen Wert eines Kanals auswerten (nach jeder Messung)
+    // true = mindestens eine Regel hat gewechselt
+    bool evaluate(uint8_t sensor, int16_t centi, uint32_t now);
+
+    // Zustand
+    uint8_t count() const;
+    uint32_t activeMask() const;       // Bit n = Regel n aktiv
+    uint32_t since(uint8_t alarm) const; // Zeitpunkt des letzten Wechsels (0 = nie)
+    uint32_t transitions() const;        // Anzahl Wechsel seit begin()
+
+private:
+    // Zwei Vergleichswerte pro Kanal: der neuere wird nach rateWindow zum älteren,
+    // die Rate bezieht sich immer auf den älteren (rateWindow bis 2 * rateWindow zurück)
+    struct RateState {
+        int16_t anchor;
+        int16_t base;
+        uint32_t anchorTime;
+        uint32_t baseTime;
+        uint8_t points; // Gültige Vergleichswerte (0..2)
+    };
+
+    const CompiledAlarm *_alarms;
+    uint8_t _count;
+    uint32_t _rateWindow;
+    uint32_t _active;
+    uint32_t _since[ALARM_MAX_RULES];
+    uint32_t _transitions;
+    RateState _rates[ALARM_MAX_SENSORS];
+
+    bool updateRate(uint8_t sensor, int16_t centi, uint32_t now, int32_t &rate);
+};
+
+#endif // ALARM_ENGINE_H
@@ -0,0 +1,113 @@
+/**
+ * @file BodyAccumulator.h
+ * @brief Collects fragmented ESPAsyncWebServer request bodies
+ *
+ * The body callback of ESPAsyncWebServer delivers a request body in
+ * pieces (index, len, total) as they arrive from TCP. BodyAccumulator
+ * reserves one buffer of exactly 'total' bytes with the first piece,
+ * copies every piece into place and terminates the body once complete.
+ * The buffer is attached to the request (_tempObject) and released by
+ * the web server together with the request, so there is one allocation
+ * per request and none per piece.
+ *
+ * Usage:
+ *   body callback:    BodyAccumulator::append(request, data, len, index, total, maxSize);
+ *   request callback: const char *body = BodyAccumulator::body(request);
+ *
+ * The request callback runs after the last piece was received.
+ *
+ * @author Johannes
+ * @version 1.0
+ * @date 2025
+ */
+
+#ifndef BODY_ACCUMULATOR_H
+#define BODY_ACCUMULATOR_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+class BodyAccumulator {
+public:
+    enum Status {
+        INCOMPLETE, // More pieces expected
+        COMPLETE,   // Body available via body()
+        TOO_LARGE,  // Body exceeds maxSize, pieces are dropped
+        NO_MEMORY,  // Buffer could not be allocated
+        INVALID     // Pieces out of order
+    };
+
+    /**
+     * @brief Store one piece of the request body
+     *
+     * @param request Request the body belongs to
+     * @param data Piece received from the web server
+     * @param len Length of the piece
+     * @param index Offset of the piece in the body
+     * @param total Announced body length
+     * @param maxSize Largest body accepted for this endpoint
+     * @return Status after this piece
+     */
+    static Status append(AsyncWebServerRequest *request, const uint8_t *data, size_t len,
+                         size_t index, size_t total, size_t maxSize) {
+        if (total > maxSize) {
+            return TOO_LARGE;
+        }
+
+        Arena *arena = static_cast<Arena *>(request->_tempObject);
+        if (index == 0 && arena == nullptr) {
+            arena = static_cast<Arena *>(malloc(sizeof(Arena) + total + 1));
+            if (arena == nullptr) {
+                return NO_MEMORY;
+            }
+            arena->total = total;
+            arena->length = 0;
+            request->_tempObject = arena;
+        }
+
+        if (arena == nullptr || index != arena->length || index + len > arena->total) {
+            return INVALID;
+        }
+
+        memcpy(arena->data + index, data, len);
+        arena->length += len;
+
+        if (arena->length < arena->total) {
+            return INCOMPLETE;
+        }
+        arena->data[arena->length] = '\0';
+        return COMPLETE;
+    }
+
+    /**
+     * @brief Complete, NUL-terminated body of a request
+     *
+     * The buffer stays valid until the request is finished.
+     *
+     * @return const char* Body, or nullptr if no complete body was received
+     */
+    static const char *body(AsyncWebServerRequest *request) {
+        Arena *arena = static_cast<Arena *>(request->_tempObject);
+        if (arena == nullptr || arena->length != arena->total) {
+            return nullptr;
+        }
+        return arena->data;
+    }
+
+    /**
+     * @brief Length of the complete body (0 if not complete)
+     */
+    static size_t length(AsyncWebServerRequest *request) {
+        return body(request) != nullptr ? static_cast<Arena *>(request->_tempObject)->length : 0;
+    }
+
+private:
+    // Buffer header, followed by total + 1 bytes of body
+    struct Arena {
+        size_t total;
+        size_t length;
+        char data[1];
+    };
+};
+
+#endif // BODY_ACCUMULATOR_H
@@ -0,0 +1,230 @@
+/**
+ * @file FirmwareUpdate.cpp
+ * @brief Streaming OTA update into the inactive app partition
+ *
+ * Every piece of the uploaded image goes straight to flash with
+ * esp_ota_write() and into a running SHA-256; nothing beyond the piece
+ * the web server already holds is buffered, so the heap use does not
+ * depend on the image size. The partition is opened for sequential
+ * writes, which erases each sector just before it is written instead
+ * of the whole partition up front (seconds in which the web server
+ * task would not run).
+ *
+ * finish() only sets the new boot partition if the digest matches the
+ * one given with the upload and esp_ota_end() accepts the image. The
+ * running firmware stays untouched until the restart.
+ *
+ * After the restart the bootloader marks the new image as pending
+ * verification (app rollback enabled). The firmware calls confirm()
+ * once it is healthy; rollback() or a crash before that returns to the
+ * previous image.
+ *
+ * @author Johannes
+ * @version 1.0
+ * @date 2025
+ */
+
+#include "FirmwareUpdate.h"
+#include <string.h>
+
+/**
+ * @brief Constructor - No upload yet
+ */
+FirmwareUpdate::FirmwareUpdate() : _state(IDLE), _received(0), _lastWrite(0) {
+    _handle = 0;
+    _partition = nullptr;
+    _size = 0;
+    _error = "";
+    memset(_expected, 0, sizeof(_expected));
+}
+
+/**
+ * @brief Parse a hex digest
+ *
+ * @return false unless hex consists of exactly 64 hex digits
+ */
+static bool parseSha256(const char *hex, uint8_t *digest) {
+    if (hex == nullptr || strlen(hex) != 64) {
+        return false;
+    }
+    for (int i = 0; i < 64; i++) {
+        char c = hex[i];
+        uint8_t nibble;
+        if (c >= '0' && c <= '9') {
+            nibble = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            nibble = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            nibble = c - 'A' + 10;
+        } else {
+            return false;
+        }
+        digest[i / 2] = (i & 1) ? (digest[i / 2] | nibble) : (nibble << 4);
+    }
+    return true;
+}
+
+/**
+ * @brief Start an upload
+ *
+ * @param size Image size in bytes (Content-Length)
+ * @param sha256Hex Expected SHA-256 of the image (64 hex digits)
+ * @return false if the digest is malformed, the image does not fit or
+ *         the partition cannot be opened (see error())
+ */
+bool FirmwareUpdate::begin(size_t size, const char *sha256Hex) {
+    if (_state == RECEIVING) {
+        abort("Replaced by a new upload");
+    }
+
+    _received = 0;
+    _size = size;
+    _lastWrite = millis();
+    _state = RECEIVING;
+
+    if (!parseSha256(sha256Hex, _expected)) {
+        fail("Missing or invalid SHA-256");
+        return false;
+    }
+
+    _partition = esp_ota_get_next_update_partition(nullptr);
+    if (_partition == nullptr) {
+        fail("No OTA partition");
+        return false;
+    }
+    if (size == 0 || size > _partition->size) {
+        fail("Image does not fit the OTA partition");
+        return false;
+    }
+    if (esp_ota_begin(_partition, OTA_WITH_SEQUENTIAL_WRITES, &_handle) != ESP_OK) {
+        fail("Partition could not be opened");
+        return false;
+    }
+
+    mbedtls_sha256_init(&_sha);
+    mbedtls_sha256_starts(&_sha, 0);
+    return true;
+}
+
+/**
+ * @brief Write the next piece of the image
+ *
+ * @param data Piece as received
+ * @param len Length of the piece
+ * @param index Offset of the piece in the image (must follow the previous one)
+ * @return false if the upload failed (now or before)
+ */
+bool FirmwareUpdate::write(const uint8_t *data, size_t len, size_t index) {
+    if (_state != RECEIVING) {
+        return false;
+    }
+    if (index != _received || index + len > _size) {
+        abort("Pieces out of order");
+        return false;
+    }
+    if (esp_ota_write(_handle, data, len) != ESP_OK) {
+        abort("Flash write failed");
+        return false;
+    }
+
+    mbedtls_sha256_update(&_sha, data, len);
+    _received += len;
+    _lastWrite = millis();
+    return true;
+}
+
+/**
+ * @brief Verify the complete image and make it the boot partition
+ *
+ * @return true if the new image boots with the next restart
+ */
+bool FirmwareUpdate::finish() {
+    if (_state != RECEIVING) {
+        return false;
+    }
+    if (_received != _size) {
+        abort("Upload incomplete");
+        return false;
+    }
+
+    uint8_t digest[32];
+    mbedtls_sha256_finish(&_sha, digest);
+    mbedtls_sha256_free(&_sha);
+    if (memcmp(digest, _expected, sizeof(digest)) != 0) {
+        esp_ota_abort(_handle);
+        fail("SHA-256 mismatch");
+        return false;
+    }
+
+    // Checks the image header, segments and the appended image hash
+    if (esp_ota_end(_handle) != ESP_OK) {
+        fail("Image invalid");
+        return false;
+    }
+    if (esp_ota_set_boot_partition(_partition) != ESP_OK) {
+        fail("Boot partition could not be set");
+        return false;
+    }
+
+    _state = DONE;
+    return true;
+}
+
+/**
+ * @brief Discard a running upload
+ *
+ * @param reason Reported by error() (string literal)
+ */
+void FirmwareUpdate::abort(const char *reason) {
+    if (_state != RECEIVING) {
+        return;
+    }
+    esp_ota_abort(_handle);
+    mbedtls_sha256_free(&_sha);
+    fail(reason);
+}
+
+void FirmwareUpdate::fail(const char *reason) {
+    _error = reason;
+    _state = FAILED;
+}
+
+FirmwareUpdate::State FirmwareUpdate::state() const {
+    return _state;
+}
+
+size_t FirmwareUpdate::received() const {
+    return _received;
+}
+
+size_t FirmwareUpdate::size() const {
+    return _size;
+}
+
+uint32_t FirmwareUpdate::lastWrite() const {
+    return _lastWrite;
+}
+
+const char *FirmwareUpdate::error() const {
+    return _state == FAILED ? _error : "";
+}
+
+/**
+ * @brief Check whether the running image still awaits confirmation
+ *
+ * @return true after the first boot of a new image (app rollback enabled
+ *         in the bootloader), until confirm() or rollback()
+ */
+bool FirmwareUpdate::pendingVerify() {
+    esp_ota_img_states_t state;
+    return esp_ota_get_state_partition(esp_ota_get_running_partition(), &state) == ESP_OK &&
+           state == ESP_OTA_IMG_PENDING_VERIFY;
+}
+
+void FirmwareUpdate::confirm() {
+    esp_ota_mark_app_valid_cancel_rollback();
+}
+
+void FirmwareUpdate::rollback() {
+    esp_ota_mark_app_invalid_rollback_and_reboot();
+}
@@ -0,0 +1,62 @@
+#ifndef FIRMWARE_UPDATE_H
+#define FIRMWARE_UPDATE_H
+
+#include <Arduino.h>
+#include <esp_ota_ops.h>
+#include <mbedtls/sha256.h>
+#include <atomic>
+
+class FirmwareUpdate {
+public:
+    // Zustand des letzten Uploads
+    enum State : uint8_t {
+        IDLE,      // Kein Upload seit dem Start
+        RECEIVING, // Upload läuft
+        DONE,      // Geprüft und als Startpartition gesetzt, Neustart ausstehend
+        FAILED     // Abgebrochen, Grund in error()
+    };
+
+    // Konstruktor
+    FirmwareUpdate();
+
+    // Upload beginnen: size Bytes, erwarteter SHA-256 als 64 Hex-Zeichen
+    // Ein laufender Upload wird verworfen
+    bool begin(size_t size, const char *sha256Hex);
+
+    // Nächstes Stück schreiben (index = Position im Image, nur lückenlos aufsteigend)
+    bool write(const uint8_t *data, size_t len, size_t index);
+
+    // Prüfsumme vergleichen, Image prüfen und als Startpartition setzen
+    bool finish();
+
+    // Upload verwerfen (Startpartition bleibt unverändert)
+    void abort(const char *reason);
+
+    // Zustand (lesbar aus anderen Tasks)
+    State state() const;
+    size_t received() const;
+    size_t size() const;
+    uint32_t lastWrite() const; // millis() des letzten Stücks
+    const char *error() const;
+
+    // Rollback: läuft ein neues Image, das noch bestätigt werden muss?
+    static bool pendingVerify();
+    // Laufendes Image bestätigen bzw. verwerfen (startet das vorherige neu)
+    static void confirm();
+    static void rollback();
+
+private:
+    esp_ota_handle_t _handle;
+    const esp_partition_t *_partition;
+    mbedtls_sha256_context _sha;
+    uint8_t _expected[32];
+    std::atomic<State> _state;
+    std::atomic<size_t> _received;
+    size_t _size;
+    std::atomic<uint32_t> _lastWrite;
+    const char *_error;
+
+    void fail(const char *reason);
+};
+
+#endif // FIRMWARE_UPDATE_H
@@ -0,0 +1,603 @@
+/**
+ * @file FlashLog.cpp
+ * @brief Append-only log of sensor readings on the flash file system
+ *
+ * Records of fixed size (Unix time plus one int16 per channel in
+ * 0.01 °C) are appended to segment files of at most segmentSize bytes.
+ * When the newest segment is full a new one is started; beyond the
+ * configured number of segments the oldest file is deleted, so the
+ * log occupies a bounded part of the file system.
+ *
+ * The producer only copies a record into a FreeRTOS queue. A separate
+ * low-priority task collects records in a RAM batch and writes the
+ * batch in one append when it is full or flushInterval has passed.
+ * The batch size bounds the length of a single flash write (and thus
+ * the time both cores stall with the flash cache disabled), the flush
+ * interval bounds the number of writes per day and the data lost on
+ * a power failure.
+ *
+ * Timestamps increase within a segment, so a segment can be searched
+ * by bisection. A RAM index with the first and last timestamp of every
+ * segment lets exports skip segments outside the requested range. If
+ * the clock steps back, the writer starts a new segment.
+ *
+ * @author Johannes
+ * @version 1.0
+ * @date 2025
+ */
+
+#include "FlashLog.h"
+#include <esp_timer.h>
+#include <algorithm>
+#include <vector>
+
+#define FLASH_LOG_MAGIC 0x474F4C38 // "8LOG"
+#define FLASH_LOG_VERSION 1
+
+/**
+ * @brief Constructor - Nothing is read or allocated until begin()
+ */
+FlashLog::FlashLog()
+    : _dropped(0), _writeErrors(0), _maxWriteMicros(0) {
+    _fs = nullptr;
+    _directory[0] = '\0';
+    _channels = 0;
+    _recordSize = 0;
+    _segmentRecords = 0;
+    _maxSegments = 0;
+    _index = nullptr;
+    _segmentCount = 0;
+    _mutex = nullptr;
+    _queue = nullptr;
+    _task = nullptr;
+    _batch = nullptr;
+    _batchCapacity = 0;
+    _batchLength = 0;
+    _batchStarted = 0;
+    _flushInterval = 0;
+    _lastTime = 0;
+    _rotate = false;
+}
+
+/**
+ * @brief Build the segment index from the files in the log directory
+ *
+ * Segments written with a different channel count are deleted, as are
+ * the oldest files beyond 'segments'.
+ *
+ * @param fs Mounted file system (e.g. LittleFS)
+ * @param directory Directory holding the segment files
+ * @param channels Values per record (max FLASH_LOG_MAX_CHANNELS)
+ * @param segmentSize Maximum size of one segment file in bytes
+ * @param segments Number of segments to keep
+ * @return true if the log is ready for startWriter()
+ */
+bool FlashLog::begin(fs::FS &fs, const char *directory, uint8_t channels, size_t segmentSize,
+                     uint16_t segments) {
+    _fs = &fs;
+    strncpy(_directory, directory, sizeof(_directory) - 1);
+    _directory[sizeof(_directory) - 1] = '\0';
+    _channels = min(channels, (uint8_t)FLASH_LOG_MAX_CHANNELS);
+    _recordSize = sizeof(uint32_t) + _channels * sizeof(int16_t);
+    _maxSegments = segments;
+
+    if (segmentSize <= sizeof(SegmentHeader) + _recordSize || segments < 2) {
+        return false;
+    }
+    _segmentRecords = (segmentSize - sizeof(SegmentHeader)) / _recordSize;
+
+    _index = new Segment[_maxSegments];
+    _mutex = xSemaphoreCreateMutex();
+    if (_index == nullptr || _mutex == nullptr) {
+        return false;
+    }
+
+    if (!_fs->exists(_directory) && !_fs->mkdir(_directory)) {
+        return false;
+    }
+
+    // Collect the segment numbers first, the directory is not modified while listing it
+    std::vector<uint32_t> serials;
+    File root = _fs->open(_directory);
+    if (!root || !root.isDirectory()) {
+        return false;
+    }
+    for (File entry = root.openNextFile(); entry; entry = root.openNextFile()) {
+        char *end = nullptr;
+        uint32_t serial = strtoul(entry.name(), &end, 10);
+        if (serial != 0 && end != nullptr && strcmp(end, ".bin") == 0) {
+            serials.push_back(serial);
+        }
+    }
+    root.close();
+    std::sort(serials.begin(), serials.end());
+
+    // Newest first, so files from another layout do not count against the limit
+    char path[40];
+    for (size_t i = serials.size(); i-- > 0;) {
+        Segment segment;
+        bool partial = false;
+        if (_segmentCount < _maxSegments && loadSegment(serials[i], segment, partial)) {
+            if (_segmentCount == 0) {
+                _rotate = partial;
+                _lastTime = segment.maxTime;
+            }
+            _index[_segmentCount++] = segment;
+        } else {
+            segmentPath(serials[i], path, sizeof(path));
+            _fs->remove(path);
+        }
+    }
+    std::reverse(_index, _index + _segmentCount);
+    return true;
+}
+
+/**
+ * @brief Start the writer task and reserve the write batch
+ *
+ * @param batchSize Bytes collected before a write (rounded down to whole records)
+ * @param flushInterval Longest time a record waits in RAM in ms
+ * @param priority FreeRTOS priority (below the acquisition task)
+ * @param core CPU core the task is pinned to
+ * @return true if the task is running
+ */
+bool FlashLog::startWriter(size_t batchSize, uint32_t flushInterval, UBaseType_t priority,
+                           BaseType_t core) {
+    if (_index == nullptr || _task != nullptr) {
+        return false;
+    }
+
+    _batchCapacity = max(batchSize / _recordSize, (size_t)1) * _recordSize;
+    _batch = (uint8_t *)malloc(_batchCapacity);
+    _flushInterval = flushInterval;
+    _queue = xQueueCreate(FLASH_LOG_QUEUE_LENGTH, sizeof(QueuedRecord));
+    if (_batch == nullptr || _queue == nullptr) {
+        return false;
+    }
+
+    return xTaskCreatePinnedToCore(writerTask, "flashlog", FLASH_LOG_TASK_STACK_SIZE, this,
+                                   priority, &_task, core) == pdPASS;
+}
+
+/**
+ * @brief Hand one record to the writer task
+ *
+ * Never waits: if the writer is stalled by a slow flash write and the
+ * queue is full, the record is counted as dropped.
+ *
+ * @param time Unix time in seconds (must not be 0)
+ * @param values One value per channel in 0.01 °C, FLASH_LOG_NO_VALUE if missing
+ * @return true if the record was queued
+ */
+bool FlashLog::append(uint32_t time, const int16_t *values) {
+    if (_queue == nullptr || time == 0) {
+        return false;
+    }
+
+    QueuedRecord record;
+    record.time = time;
+    memcpy(record.values, values, _channels * sizeof(int16_t));
+
+    if (xQueueSend(_queue, &record, 0) != pdTRUE) {
+        _dropped++;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Ask the writer task to write its batch now
+ *
+ * Returns immediately; records queued before the call are included.
+ */
+void FlashLog::flush() {
+    if (_queue == nullptr) {
+        return;
+    }
+
+    QueuedRecord marker;
+    marker.time = 0;
+    xQueueSend(_queue, &marker, 0);
+}
+
+/**
+ * @brief Position a cursor before the first record in [from, to]
+ *
+ * The segment and the byte range are resolved lazily by read().
+ */
+void FlashLog::seek(Cursor &cursor, uint32_t from, uint32_t to) const {
+    cursor.from = from;
+    cursor.to = to;
+    cursor.serial = 0;
+    cursor.position = 0;
+    cursor.end = 0;
+}
+
+/**
+ * @brief Copy the next part of the exported range into a buffer
+ *
+ * Reads straight from the segment files into 'buffer'; records may be
+ * split across calls. Each call opens the file it reads from and does
+ * not hold the index lock during file access, so a long export never
+ * blocks the writer. A segment deleted by rotation while it is being
+ * exported is skipped. Records still in the write batch are not
+ * included.
+ *
+ * @param cursor Cursor from seek()
+ * @param buffer Destination (e.g. the HTTP response buffer)
+ * @param maxLen Capacity of the buffer
+ * @return size_t Bytes copied, 0 at the end of the range
+ */
+size_t FlashLog::read(Cursor &cursor, uint8_t *buffer, size_t maxLen) const {
+    if (_index == nullptr) {
+        return 0;
+    }
+
+    char path[40];
+    size_t written = 0;
+    while (written < maxLen) {
+        if (cursor.position >= cursor.end) {
+            Segment segment;
+            if (!nextSegment(cursor.serial, cursor.from, cursor.to, segment)) {
+                break;
+            }
+            cursor.serial = segment.serial;
+            cursor.position = 0;
+            cursor.end = 0;
+
+            segmentPath(segment.serial, path, sizeof(path));
+            File file = _fs->open(path, FILE_READ);
+            if (!file) {
+                continue;
+            }
+            uint32_t first = cursor.from <= segment.minTime ? 0 : findRecord(file, segment, cursor.from, false);
+            uint32_t last = cursor.to >= segment.maxTime ? segment.records : findRecord(file, segment, cursor.to, true);
+            file.close();
+
+            cursor.position = sizeof(SegmentHeader) + first * _recordSize;
+            cursor.end = sizeof(SegmentHeader) + last * _recordSize;
+            continue;
+        }
+
+        segmentPath(cursor.serial, path, sizeof(path));
+        File file = _fs->open(path, FILE_READ);
+        size_t len = 0;
+        if (file && file.seek(cursor.position)) {
+            len = file.read(buffer + written, min(maxLen - written, (size_t)(cursor.end - cursor.position)));
+        }
+        file.close();
+
+        if (len == 0) {
+            cursor.position = cursor.end; // Deleted or truncated, continue with the next segment
+            continue;
+        }
+        cursor.position += len;
+        written += len;
+    }
+    return written;
+}
+
+uint8_t FlashLog::channels() const {
+    return _channels;
+}
+
+size_t FlashLog::recordSize() const {
+    return _recordSize;
+}
+
+uint32_t FlashLog::capacityRecords() const {
+    return _segmentRecords * _maxSegments;
+}
+
+uint32_t FlashLog::storedRecords() const {
+    if (_mutex == nullptr) {
+        return 0;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    uint32_t records = 0;
+    for (uint16_t i = 0; i < _segmentCount; i++) {
+        records += _index[i].records;
+    }
+    xSemaphoreGive(_mutex);
+    return records;
+}
+
+uint16_t FlashLog::segmentCount() const {
+    return _segmentCount;
+}
+
+uint32_t FlashLog::oldestTime() const {
+    if (_mutex == nullptr) {
+        return 0;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    uint32_t time = 0;
+    for (uint16_t i = 0; i < _segmentCount; i++) {
+        if (_index[i].records > 0 && (time == 0 || _index[i].minTime < time)) {
+            time = _index[i].minTime;
+        }
+    }
+    xSemaphoreGive(_mutex);
+    return time;
+}
+
+uint32_t FlashLog::newestTime() const {
+    if (_mutex == nullptr) {
+        return 0;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    uint32_t time = 0;
+    for (uint16_t i = 0; i < _segmentCount; i++) {
+        if (_index[i].records > 0 && _index[i].maxTime > time) {
+            time = _index[i].maxTime;
+        }
+    }
+    xSemaphoreGive(_mutex);
+    return time;
+}
+
+uint32_t FlashLog::droppedRecords() const {
+    return _dropped;
+}
+
+uint32_t FlashLog::writeErrors() const {
+    return _writeErrors;
+}
+
+uint32_t FlashLog::maxWriteMicros() const {
+    return _maxWriteMicros;
+}
+
+void FlashLog::writerTask(void *param) {
+    static_cast<FlashLog *>(param)->runWriter();
+}
+
+/**
+ * @brief Writer task body: batch queued records, write on size or age
+ */
+void FlashLog::runWriter() {
+    for (;;) {
+        TickType_t wait = portMAX_DELAY;
+        if (_batchLength > 0) {
+            uint32_t age = millis() - _batchStarted;
+            wait = age >= _flushInterval ? 0 : pdMS_TO_TICKS(_flushInterval - age);
+        }
+
+        QueuedRecord record;
+        if (xQueueReceive(_queue, &record, wait) != pdTRUE) {
+            writeBatch(); // Flush interval elapsed
+        } else if (record.time == 0) {
+            writeBatch(); // flush()
+        } else {
+            bufferRecord(record);
+        }
+    }
+}
+
+/**
+ * @brief Add a record to the batch, write the batch when it is full
+ */
+void FlashLog::bufferRecord(const QueuedRecord &record) {
+    if (record.time < _lastTime) {
+        // Clock stepped back: keep every segment sorted by time
+        writeBatch();
+        _rotate = true;
+    }
+    _lastTime = record.time;
+
+    if (_batchLength == 0) {
+        _batchStarted = millis();
+    }
+    memcpy(_batch + _batchLength, &record.time, sizeof(uint32_t));
+    memcpy(_batch + _batchLength + sizeof(uint32_t), record.values, _channels * sizeof(int16_t));
+    _batchLength += _recordSize;
+
+    if (_batchLength + _recordSize > _batchCapacity) {
+        writeBatch();
+    }
+}
+
+/**
+ * @brief Append the batch to the newest segment, rotating as needed
+ *
+ * A failed write drops the batch and starts a new segment, so a
+ * partially written record never shifts the records after it.
+ */
+void FlashLog::writeBatch() {
+    if (_batchLength == 0) {
+        return;
+    }
+
+    int64_t start = esp_timer_get_time();
+    char path[40];
+    size_t offset = 0;
+    while (offset < _batchLength) {
+        if (_segmentCount == 0 || _rotate || _index[_segmentCount - 1].records >= _segmentRecords) {
+            if (!startSegment()) {
+                _writeErrors++;
+                break;
+            }
+            _rotate = false;
+        }
+
+        // Only the writer task changes the index, reading it here needs no lock
+        Segment current = _index[_segmentCount - 1];
+        uint32_t count = min((uint32_t)((_batchLength - offset) / _recordSize),
+                             _segmentRecords - current.records);
+        size_t bytes = count * _recordSize;
+
+        segmentPath(current.serial, path, sizeof(path));
+        File file = _fs->open(path, FILE_APPEND);
+        size_t len = file ? file.write(_batch + offset, bytes) : 0;
+        file.close();
+
+        if (len != bytes) {
+            _writeErrors++;
+            _rotate = true;
+            break;
+        }
+
+        uint32_t firstTime;
+        uint32_t lastTime;
+        memcpy(&firstTime, _batch + offset, sizeof(uint32_t));
+        memcpy(&lastTime, _batch + offset + bytes - _recordSize, sizeof(uint32_t));
+
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+        Segment &segment = _index[_segmentCount - 1];
+        if (segment.records == 0) {
+            segment.minTime = firstTime;
+        }
+        segment.maxTime = lastTime;
+        segment.records += count;
+        xSemaphoreGive(_mutex);
+
+        offset += bytes;
+    }
+    _batchLength = 0;
+
+    uint32_t duration = (uint32_t)(esp_timer_get_time() - start);
+    if (duration > _maxWriteMicros) {
+        _maxWriteMicros = duration;
+    }
+}
+
+/**
+ * @brief Create the next segment file, deleting the oldest one if needed
+ */
+bool FlashLog::startSegment() {
+    char path[40];
+    uint32_t serial = _segmentCount > 0 ? _index[_segmentCount - 1].serial + 1 : 1;
+
+    if (_segmentCount >= _maxSegments) {
+        // Remove from the index first, readers skip a segment whose file is gone
+        uint32_t oldest = _index[0].serial;
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+        memmove(_index, _index + 1, (_segmentCount - 1) * sizeof(Segment));
+        _segmentCount--;
+        xSemaphoreGive(_mutex);
+
+        segmentPath(oldest, path, sizeof(path));
+        _fs->remove(path);
+    }
+
+    SegmentHeader header;
+    header.magic = FLASH_LOG_MAGIC;
+    header.version = FLASH_LOG_VERSION;
+    header.channels = _channels;
+    header.recordSize = _recordSize;
+    header.serial = serial;
+
+    segmentPath(serial, path, sizeof(path));
+    File file = _fs->open(path, FILE_WRITE);
+    size_t len = file ? file.write((const uint8_t *)&header, sizeof(header)) : 0;
+    file.close();
+    if (len != sizeof(header)) {
+        _fs->remove(path);
+        return false;
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Segment &segment = _index[_segmentCount++];
+    segment.serial = serial;
+    segment.minTime = 0;
+    segment.maxTime = 0;
+    segment.records = 0;
+    xSemaphoreGive(_mutex);
+    return true;
+}
+
+/**
+ * @brief Validate one segment file and build its index entry
+ *
+ * A trailing partial record (power failure during a write) is ignored;
+ * if it is in the newest segment, the writer continues in a new one.
+ *
+ * @param segment Index entry of the file
+ * @param partial Set if the file ends with a partial record
+ * @return false if the file does not belong to this log layout
+ */
+bool FlashLog::loadSegment(uint32_t serial, Segment &segment, bool &partial) {
+    char path[40];
+    segmentPath(serial, path, sizeof(path));
+    File file = _fs->open(path, FILE_READ);
+    if (!file) {
+        return false;
+    }
+
+    SegmentHeader header;
+    bool valid = file.read((uint8_t *)&header, sizeof(header)) == sizeof(header) &&
+                 header.magic == FLASH_LOG_MAGIC && header.version == FLASH_LOG_VERSION &&
+                 header.channels == _channels && header.recordSize == _recordSize &&
+                 header.serial == serial;
+    if (!valid) {
+        file.close();
+        return false;
+    }
+
+    size_t payload = file.size() - sizeof(SegmentHeader);
+    segment.serial = serial;
+    segment.records = min((uint32_t)(payload / _recordSize), _segmentRecords);
+    segment.minTime = segment.records > 0 ? recordTime(file, 0) : 0;
+    segment.maxTime = segment.records > 0 ? recordTime(file, segment.records - 1) : 0;
+    file.close();
+
+    partial = payload % _recordSize != 0;
+    return true;
+}
+
+void FlashLog::segmentPath(uint32_t serial, char *path, size_t size) const {
+    snprintf(path, size, "%s/%08lu.bin", _directory, (unsigned long)serial);
+}
+
+/**
+ * @brief Timestamp of one record of an open segment file
+ */
+uint32_t FlashLog::recordTime(fs::File &file, uint32_t record) const {
+    uint32_t time = 0;
+    if (file.seek(sizeof(SegmentHeader) + record * _recordSize)) {
+        file.read((uint8_t *)&time, sizeof(time));
+    }
+    return time;
+}
+
+/**
+ * @brief Bisect a segment for a timestamp
+ *
+ * @param after false: first record with time >= 'time', true: first record with time > 'time'
+ * @return uint32_t Record number (segment.records if there is none)
+ */
+uint32_t FlashLog::findRecord(fs::File &file, const Segment &segment, uint32_t time, bool after) const {
+    uint32_t low = 0;
+    uint32_t high = segment.records;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        uint32_t midTime = recordTime(file, mid);
+        if (midTime < time || (after && midTime == time)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/**
+ * @brief First segment after 'serial' with records in [from, to]
+ *
+ * @param segment Copy of the index entry (taken under the lock)
+ * @return false if there is none
+ */
+bool FlashLog::nextSegment(uint32_t serial, uint32_t from, uint32_t to, Segment &segment) const {
+    bool found = false;
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    for (uint16_t i = 0; i < _segmentCount; i++) {
+        const Segment &entry = _index[i];
+        if (entry.serial > serial && entry.records > 0 && entry.maxTime >= from && entry.minTime <= to) {
+            segment = entry;
+            found = true;
+            break;
+        }
+    }
+    xSemaphoreGive(_mutex);
+    return found;
+}
@@ -0,0 +1,128 @@
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <atomic>
+
+// Maximale Anzahl Kanäle pro Datensatz
+#define FLASH_LOG_MAX_CHANNELS 32
+
+// Datensätze, die zwischen Erfassung und Schreib-Task gepuffert werden
+#define FLASH_LOG_QUEUE_LENGTH 16
+
+// Stack des Schreib-Tasks in Bytes
+#define FLASH_LOG_TASK_STACK_SIZE 4096
+
+// Markierung für fehlende Werte
+#define FLASH_LOG_NO_VALUE INT16_MIN
+
+class FlashLog {
+public:
+    // Export-Position (von seek() gesetzt, von read() weitergeschoben)
+    struct Cursor {
+        uint32_t from;     // Zeitbereich (Unix-Zeit, inklusive)
+        uint32_t to;
+        uint32_t serial;   // Aktuelles Segment (0 = noch keins)
+        uint32_t position; // Nächstes Byte in der Segmentdatei
+        uint32_t end;      // Ende des Bereichs in der Segmentdatei
+    };
+
+    // Konstruktor
+    FlashLog();
+
+    // Vorhandene Segmente einlesen (Verzeichnis wird bei Bedarf angelegt)
+    bool begin(fs::FS &fs, const char *directory, uint8_t channels, size_t segmentSize,
+               uint16_t segments);
+
+    // Schreib-Task starten (Stapel von batchSize Bytes, spätestens nach flushInterval ms)
+    bool startWriter(size_t batchSize, uint32_t flushInterval, UBaseType_t priority, BaseType_t core);
+
+    // Datensatz anhängen, blockiert nie (false = Warteschlange voll, verworfen)
+    // Zeit in Unix-Sekunden, Werte in 0.01 °C, FLASH_LOG_NO_VALUE = kein Wert
+    bool append(uint32_t time, const int16_t *values);
+
+    // Gepufferte Datensätze sofort schreiben lassen (z.B. vor einem Neustart)
+    void flush();
+
+    // Export: rohe Datensätze im Zeitbereich, direkt aus der Datei in den Puffer
+    void seek(Cursor &cursor, uint32_t from, uint32_t to) const;
+    size_t read(Cursor &cursor, uint8_t *buffer, size_t maxLen) const;
+
+    // Statistik
+    uint8_t channels() const;
+    size_t recordSize() const;
+    uint32_t capacityRecords() const;
+    uint32_t storedRecords() const;
+    uint16_t segmentCount() const;
+    uint32_t oldestTime() const;
+    uint32_t newestTime() const;
+    uint32_t droppedRecords() const;
+    uint32_t writeErrors() const;
+    uint32_t maxWriteMicros() const;
+
+private:
+    // Kopf jeder Segmentdatei, danach folgen die Datensätze:
+    //   uint32_t time; int16_t values[channels]   (little endian, ohne Füllbytes)
+    struct SegmentHeader {
+        uint32_t magic;
+        uint8_t version;
+        uint8_t channels;
+        uint16_t recordSize;
+        uint32_t serial;
+    };
+
+    // Index-Eintrag pro Segment (im RAM, beim Start aus den Dateien aufgebaut)
+    struct Segment {
+        uint32_t serial;   // Laufende Nummer = Dateiname
+        uint32_t minTime;  // Zeit des ersten Datensatzes
+        uint32_t maxTime;  // Zeit des letzten Datensatzes
+        uint32_t records;  // Geschriebene Datensätze
+    };
+
+    // Element der Warteschlange (time 0 = flush())
+    struct QueuedRecord {
+        uint32_t time;
+        int16_t values[FLASH_LOG_MAX_CHANNELS];
+    };
+
+    fs::FS *_fs;
+    char _directory[24];
+    uint8_t _channels;
+    size_t _recordSize;
+    uint32_t _segmentRecords; // Datensätze pro Segment
+    uint16_t _maxSegments;
+
+    Segment *_index;          // Nach Nummer sortiert, ältestes zuerst
+    uint16_t _segmentCount;
+    SemaphoreHandle_t _mutex; // Schützt nur den Index, nie während Flash-Zugriffen gehalten
+
+    // Schreib-Task (alle Felder gehören dem Task)
+    QueueHandle_t _queue;
+    TaskHandle_t _task;
+    uint8_t *_batch;
+    size_t _batchCapacity;
+    size_t _batchLength;
+    uint32_t _batchStarted;   // millis() des ersten gepufferten Datensatzes
+    uint32_t _flushInterval;
+    uint32_t _lastTime;       // Zeit des zuletzt gepufferten Datensatzes
+    bool _rotate;             // Nächster Stapel beginnt ein neues Segment
+
+    std::atomic<uint32_t> _dropped;
+    std::atomic<uint32_t> _writeErrors;
+    std::atomic<uint32_t> _maxWriteMicros;
+
+    // Hilfsfunktionen
+    static void writerTask(void *param);
+    void runWriter();
+    void bufferRecord(const QueuedRecord &record);
+    void writeBatch();
+    bool startSegment();
+    bool loadSegment(uint32_t serial, Segment &segment, bool &partial);
+    void segmentPath(uint32_t serial, char *path, size_t size) const;
+    uint32_t recordTime(fs::File &file, uint32_t record) const;
+    uint32_t findRecord(fs::File &file, const Segment &segment, uint32_t time, bool after) const;
+    bool nextSegment(uint32_t serial, uint32_t from, uint32_t to, Segment &segment) const;
+};
+
+#endif // FLASH_LOG_H
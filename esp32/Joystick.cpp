@@ -44,6 +44,13 @@ Joystick::Joystick(int pinX, int pinY, int pinSwitch) {
     _lastSwitchTime = 0;
     _lastPositionTime = 0;
     
+    _eventQueue = nullptr;
+    _sampleTimer = nullptr;
+    _notifyTask = nullptr;
+    _hysteresis = 0;
+    _lastSwitchEdge = 0;
+    _sampledPosition = JOY_CENTER;
+    
     // Callbacks auf nullptr setzen
     _callbackLeft = nullptr;
     _callbackRight = nullptr;
@@ -65,6 +72,62 @@ void Joystick::begin() {
     pinMode(_pinSwitch, INPUT_PULLUP);
 }
 
+/**
+ * @brief Switch to interrupt/timer driven operation
+ * 
+ * The button raises a GPIO interrupt on every edge (debounced in the
+ * ISR), the axes are sampled by an esp_timer at a low rate. A direction
+ * is entered beyond the deadzone and only left again when the deflection
+ * drops below (deadzone - hysteresis), so a stick resting near the
+ * threshold does not chatter. Events are queued; update() invokes the
+ * callbacks in the calling task, so callbacks never run in interrupt
+ * or timer context.
+ * 
+ * Call after begin() and setThresholds().
+ * 
+ * @param sampleInterval Axis sampling interval in milliseconds
+ * @param hysteresis ADC counts subtracted from the deadzone when leaving a direction
+ * @return true if queue and timer could be created
+ */
+bool Joystick::beginEventMode(uint32_t sampleInterval, int hysteresis) {
+    _hysteresis = hysteresis;
+    
+    _eventQueue = xQueueCreate(JOYSTICK_QUEUE_LENGTH, sizeof(JoystickEvent));
+    if (_eventQueue == nullptr) {
+        return false;
+    }
+    
+    const esp_timer_create_args_t timerArgs = {
+        .callback = sampleTimerCallback,
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "joystick",
+        .skip_unhandled_events = true,
+    };
+    if (esp_timer_create(&timerArgs, &_sampleTimer) != ESP_OK) {
+        return false;
+    }
+    esp_timer_start_periodic(_sampleTimer, sampleInterval * 1000ULL);
+    
+    attachInterruptArg(_pinSwitch, switchISR, this, CHANGE);
+    
+    if (_debugMode) {
+        Serial.println("Joystick event mode active");
+    }
+    return true;
+}
+
+/**
+ * @brief Set a task to be notified whenever an event is queued
+ * 
+ * Lets the task block in ulTaskNotifyTake() instead of polling.
+ * 
+ * @param task Task handle, or nullptr to disable notifications
+ */
+void Joystick::setNotifyTask(TaskHandle_t task) {
+    _notifyTask = task;
+}
+
 void Joystick::setThresholds(int minVal, int maxVal, int centerVal, int deadzone) {
     _minVal = minVal;
     _maxVal = maxVal;
@@ -134,6 +197,32 @@ void Joystick::onSwitch(void (*callback)()) {
 }
 
 void Joystick::update() {
+    // Ereignismodus: nur Warteschlange abarbeiten
+    if (_eventQueue != nullptr) {
+        JoystickEvent event;
+        while (xQueueReceive(_eventQueue, &event, 0) == pdTRUE) {
+            if (event.isSwitch) {
+                if (_debugMode) {
+                    Serial.println(">>> Joystick Switch gedrückt");
+                }
+                if (_callbackSwitch != nullptr) {
+                    _callbackSwitch();
+                }
+            } else {
+                if (_debugMode) {
+                    Serial.print(">>> Position geändert: ");
+                    Serial.print(getPositionString(_currentPosition));
+                    Serial.print(" -> ");
+                    Serial.println(getPositionString(event.position));
+                }
+                _previousPosition = event.position;
+                _currentPosition = event.position;
+                dispatchPosition(event.position);
+            }
+        }
+        return;
+    }
+    
     unsigned long currentTime = millis();
     
     // Analoge Werte auslesen
@@ -190,23 +279,7 @@ void Joystick::update() {
                 Serial.println(getPositionString(newPosition));
             }
             
-            switch (newPosition) {
-                case JOY_LEFT:
-                    if (_callbackLeft != nullptr) _callbackLeft();
-                    break;
-                case JOY_RIGHT:
-                    if (_callbackRight != nullptr) _callbackRight();
-                    break;
-                case JOY_UP:
-                    if (_callbackUp != nullptr) _callbackUp();
-                    break;
-                case JOY_DOWN:
-                    if (_callbackDown != nullptr) _callbackDown();
-                    break;
-                case JOY_CENTER:
-                    if (_callbackCenter != nullptr) _callbackCenter();
-                    break;
-            }
+            dispatchPosition(newPosition);
             
             _previousPosition = newPosition;
             _currentPosition = newPosition;
@@ -285,6 +358,139 @@ JoystickPosition Joystick::calculatePosition() {
     }
 }
 
+/**
+ * @brief Deflection of the current readings in the direction of a position
+ * 
+ * @param pos Direction to measure (JOY_CENTER returns 0)
+ * @return int Distance from center along that direction (negative = opposite side)
+ */
+int Joystick::axisDeflection(JoystickPosition pos) {
+    int x = _currentX;
+    int y = _currentY;
+    
+    if (_invertX) {
+        x = _maxVal - (x - _minVal) + _minVal;
+    }
+    if (_invertY) {
+        y = _maxVal - (y - _minVal) + _minVal;
+    }
+    
+    switch (pos) {
+        case JOY_RIGHT: return x - _centerVal;
+        case JOY_LEFT: return _centerVal - x;
+        case JOY_UP: return y - _centerVal;
+        case JOY_DOWN: return _centerVal - y;
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Invoke the callback registered for a position
+ */
+void Joystick::dispatchPosition(JoystickPosition pos) {
+    switch (pos) {
+        case JOY_LEFT:
+            if (_callbackLeft != nullptr) _callbackLeft();
+            break;
+        case JOY_RIGHT:
+            if (_callbackRight != nullptr) _callbackRight();
+            break;
+        case JOY_UP:
+            if (_callbackUp != nullptr) _callbackUp();
+            break;
+        case JOY_DOWN:
+            if (_callbackDown != nullptr) _callbackDown();
+            break;
+        case JOY_CENTER:
+            if (_callbackCenter != nullptr) _callbackCenter();
+            break;
+    }
+}
+
+/**
+ * @brief Queue an event and wake the consumer task (task context only)
+ * 
+ * A full queue drops the event: the user is faster than the consumer,
+ * losing one scroll step is preferable to blocking the timer task.
+ */
+void Joystick::postEvent(const JoystickEvent &event) {
+    if (xQueueSend(_eventQueue, &event, 0) == pdTRUE && _notifyTask != nullptr) {
+        xTaskNotifyGive(_notifyTask);
+    }
+}
+
+/**
+ * @brief Sample both axes and queue a position change (esp_timer task)
+ */
+void Joystick::sampleAxes() {
+    _currentX = analogRead(_pinX);
+    _currentY = analogRead(_pinY);
+    
+    // Losgelassen-Flanke im Prellen verschluckt: Zustand nachführen,
+    // damit der nächste Tastendruck wieder erkannt wird
+    if (_currentSwitch && digitalRead(_pinSwitch) == HIGH &&
+        esp_timer_get_time() - _lastSwitchEdge > (int64_t)_debounceDelay * 1000) {
+        _currentSwitch = false;
+    }
+    
+    JoystickPosition newPosition = calculatePosition();
+    
+    // Hysterese: aktuelle Richtung erst unterhalb (Totbereich - Hysterese) verlassen
+    if (_sampledPosition != JOY_CENTER && newPosition != _sampledPosition &&
+        axisDeflection(_sampledPosition) >= _deadzone - _hysteresis) {
+        newPosition = _sampledPosition;
+    }
+    
+    if (newPosition != _sampledPosition) {
+        _sampledPosition = newPosition;
+        
+        JoystickEvent event;
+        event.isSwitch = false;
+        event.position = newPosition;
+        postEvent(event);
+    }
+}
+
+void Joystick::sampleTimerCallback(void *arg) {
+    static_cast<Joystick *>(arg)->sampleAxes();
+}
+
+/**
+ * @brief Button interrupt (both edges)
+ * 
+ * Edges within the debounce delay of the previous edge are ignored.
+ * Only presses are queued; the released state is tracked for
+ * isSwitchPressed().
+ */
+void IRAM_ATTR Joystick::switchISR(void *arg) {
+    Joystick *joystick = static_cast<Joystick *>(arg);
+    int64_t now = esp_timer_get_time();
+    
+    if (now - joystick->_lastSwitchEdge < (int64_t)joystick->_debounceDelay * 1000) {
+        return;
+    }
+    joystick->_lastSwitchEdge = now;
+    
+    bool pressed = (digitalRead(joystick->_pinSwitch) == LOW);
+    if (pressed == joystick->_currentSwitch) {
+        return;
+    }
+    joystick->_currentSwitch = pressed;
+    
+    if (pressed) {
+        JoystickEvent event;
+        event.isSwitch = true;
+        event.position = joystick->_sampledPosition;
+        
+        BaseType_t woken = pdFALSE;
+        if (xQueueSendFromISR(joystick->_eventQueue, &event, &woken) == pdTRUE &&
+            joystick->_notifyTask != nullptr) {
+            vTaskNotifyGiveFromISR(joystick->_notifyTask, &woken);
+        }
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
 /**
  * @brief Get current calculated position
  * @return Current joystick position as enum value
@@ -2,6 +2,10 @@
 #define JOYSTICK_H
 
 #include <Arduino.h>
+#include <esp_timer.h>
+
+// Länge der Ereignis-Warteschlange im Ereignismodus
+#define JOYSTICK_QUEUE_LENGTH 8
 
 enum JoystickPosition {
     JOY_CENTER,
@@ -11,6 +15,12 @@ enum JoystickPosition {
     JOY_RIGHT
 };
 
+// Ereignis aus Interrupt bzw. Abtast-Timer (Ereignismodus)
+struct JoystickEvent {
+    bool isSwitch;                // true = Taster gedrückt, false = Positionswechsel
+    JoystickPosition position;    // Neue Position
+};
+
 class Joystick {
 public:
     // Konstruktor
@@ -18,6 +28,11 @@ public:
     
     // Initialisierung
     void begin();
+
+    // Ereignismodus: Taster per GPIO-Interrupt, Achsen per Timer mit Hysterese
+    // Callbacks laufen danach in update() des aufrufenden Tasks
+    bool beginEventMode(uint32_t sampleInterval, int hysteresis);
+    void setNotifyTask(TaskHandle_t task);  // Task bei neuem Ereignis aufwecken
     
     // Konfiguration
     void setThresholds(int minVal, int maxVal, int centerVal, int deadzone);
@@ -33,7 +48,8 @@ public:
     void onCenter(void (*callback)());
     void onSwitch(void (*callback)());
     
-    // Update-Funktion (muss regelmäßig aufgerufen werden)
+    // Update-Funktion (muss regelmäßig aufgerufen werden,
+    // im Ereignismodus nur zum Abarbeiten der Warteschlange)
     void update();
     
     // Aktuelle Position abfragen
@@ -64,7 +80,7 @@ private:
     // Aktuelle Werte
     int _currentX;
     int _currentY;
-    bool _currentSwitch;
+    volatile bool _currentSwitch;
     JoystickPosition _currentPosition;
     
     // Vorherige Werte (für Änderungserkennung)
@@ -84,8 +100,22 @@ private:
     unsigned long _lastPositionTime;
     const unsigned long _debounceDelay = 50;
     
+    // Ereignismodus
+    QueueHandle_t _eventQueue;
+    esp_timer_handle_t _sampleTimer;
+    TaskHandle_t _notifyTask;
+    int _hysteresis;
+    volatile int64_t _lastSwitchEdge;   // Zeitpunkt der letzten Tasterflanke (us)
+    JoystickPosition _sampledPosition;  // Position laut Abtast-Timer
+    
     // Hilfsfunktionen
     JoystickPosition calculatePosition();
+    int axisDeflection(JoystickPosition pos);
+    void dispatchPosition(JoystickPosition pos);
+    void postEvent(const JoystickEvent &event);
+    void sampleAxes();
+    static void switchISR(void *arg);
+    static void sampleTimerCallback(void *arg);
     const char* getPositionString(JoystickPosition pos);
 };
 
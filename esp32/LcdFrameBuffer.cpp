@@ -0,0 +1,148 @@
+/**
+ * @file LcdFrameBuffer.cpp
+ * @brief Framebuffer-backed renderer for HD44780 character displays
+ *
+ * Keeps a shadow copy of what is currently shown on the display and a
+ * back buffer that is drawn into like a normal Print target. flush()
+ * compares both and sends only the changed character runs over I2C,
+ * so unchanged frames cost no bus traffic at all and scrolling does
+ * not need a flickering lcd.clear().
+ *
+ * @author Johannes
+ * @version 1.0
+ * @date 2025
+ */
+
+#include "LcdFrameBuffer.h"
+
+/**
+ * @brief Constructor - Bind the renderer to an LCD
+ *
+ * @param lcd Initialized LCD driver
+ * @param cols Number of columns (max LCD_FRAME_MAX_COLS)
+ * @param rows Number of rows (max LCD_FRAME_MAX_ROWS)
+ * @param lowerRowOffset Column correction applied to rows 3 and 4
+ *                       (16x4 modules driven with 20x4 row addresses: -4)
+ */
+LcdFrameBuffer::LcdFrameBuffer(LiquidCrystal_I2C &lcd, uint8_t cols, uint8_t rows, int8_t lowerRowOffset)
+    : _lcd(lcd) {
+    _cols = min(cols, (uint8_t)LCD_FRAME_MAX_COLS);
+    _rows = min(rows, (uint8_t)LCD_FRAME_MAX_ROWS);
+    _lowerRowOffset = lowerRowOffset;
+
+    _cursorCol = 0;
+    _cursorRow = 0;
+
+    memset(_shadow, ' ', sizeof(_shadow));
+    memset(_back, ' ', sizeof(_back));
+}
+
+/**
+ * @brief Synchronize the shadow buffer with a freshly cleared display
+ *
+ * Call after lcd.clear() whenever the display was written directly
+ * (splash screen, status messages) so the next flush() starts from
+ * the correct state.
+ */
+void LcdFrameBuffer::begin() {
+    memset(_shadow, ' ', sizeof(_shadow));
+    clear();
+}
+
+/**
+ * @brief Clear the back buffer and move the cursor home
+ *
+ * Does not touch the display; blank cells are only sent on flush()
+ * where they differ from the shadow.
+ */
+void LcdFrameBuffer::clear() {
+    memset(_back, ' ', sizeof(_back));
+    _cursorCol = 0;
+    _cursorRow = 0;
+}
+
+void LcdFrameBuffer::setCursor(uint8_t col, uint8_t row) {
+    _cursorCol = col;
+    _cursorRow = row;
+}
+
+/**
+ * @brief Write one character into the back buffer
+ *
+ * Characters beyond the end of the row are dropped (no wrapping).
+ *
+ * @param c Character code (HD44780 character set)
+ * @return size_t 1 if stored, 0 if outside the visible area
+ */
+size_t LcdFrameBuffer::write(uint8_t c) {
+    if (_cursorRow >= _rows || _cursorCol >= _cols) {
+        return 0;
+    }
+    _back[_cursorRow][_cursorCol++] = (char)c;
+    return 1;
+}
+
+/**
+ * @brief Force a full redraw on the next flush()
+ */
+void LcdFrameBuffer::invalidate() {
+    memset(_shadow, 0, sizeof(_shadow));
+}
+
+/**
+ * @brief Push all changed character runs to the display
+ *
+ * Runs separated by a single unchanged character are merged: rewriting
+ * that character costs the same as a cursor command.
+ *
+ * @return int Number of characters sent to the display
+ */
+int LcdFrameBuffer::flush() {
+    int written = 0;
+
+    for (uint8_t row = 0; row < _rows; row++) {
+        uint8_t col = 0;
+        while (col < _cols) {
+            if (_back[row][col] == _shadow[row][col]) {
+                col++;
+                continue;
+            }
+
+            // Find the end of the changed run (bridging single-cell gaps)
+            uint8_t end = col + 1;
+            while (end < _cols) {
+                if (_back[row][end] != _shadow[row][end]) {
+                    end++;
+                } else if (end + 1 < _cols && _back[row][end + 1] != _shadow[row][end + 1]) {
+                    end += 2;
+                } else {
+                    break;
+                }
+            }
+
+            setHardwareCursor(col, row);
+            for (uint8_t i = col; i < end; i++) {
+                _lcd.write((uint8_t)_back[row][i]);
+                _shadow[row][i] = _back[row][i];
+            }
+            written += end - col;
+            col = end;
+        }
+    }
+
+    return written;
+}
+
+/**
+ * @brief Position the display cursor, applying the lower row correction
+ *
+ * The correction is passed through as an unsigned column, matching the
+ * workaround used by the rest of the firmware.
+ */
+void LcdFrameBuffer::setHardwareCursor(uint8_t col, uint8_t row) {
+    int hardwareCol = col;
+    if (row > 1) {
+        hardwareCol += _lowerRowOffset;
+    }
+    _lcd.setCursor((uint8_t)hardwareCol, row);
+}
@@ -0,0 +1,50 @@
+#ifndef LCD_FRAME_BUFFER_H
+#define LCD_FRAME_BUFFER_H
+
+#include <Arduino.h>
+#include <LiquidCrystal_I2C.h>
+
+// Maximale Displaygröße (HD44780: bis 20x4)
+#define LCD_FRAME_MAX_COLS 20
+#define LCD_FRAME_MAX_ROWS 4
+
+class LcdFrameBuffer : public Print {
+public:
+    // Konstruktor
+    // lowerRowOffset: Spaltenkorrektur für Zeile 3 und 4 (16x4-Displays: -4)
+    LcdFrameBuffer(LiquidCrystal_I2C &lcd, uint8_t cols, uint8_t rows, int8_t lowerRowOffset = 0);
+
+    // Initialisierung (nach lcd.clear() aufrufen)
+    void begin();
+
+    // Zeichnen in den Hintergrundpuffer
+    void clear();
+    void setCursor(uint8_t col, uint8_t row);
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+    // Nächstes flush() zeichnet alles neu
+    void invalidate();
+
+    // Geänderte Bereiche an das Display senden
+    int flush();
+
+private:
+    LiquidCrystal_I2C &_lcd;
+    uint8_t _cols;
+    uint8_t _rows;
+    int8_t _lowerRowOffset;
+
+    // Cursor im Hintergrundpuffer
+    uint8_t _cursorCol;
+    uint8_t _cursorRow;
+
+    // Inhalt, der gerade auf dem Display steht / als nächstes stehen soll
+    char _shadow[LCD_FRAME_MAX_ROWS][LCD_FRAME_MAX_COLS];
+    char _back[LCD_FRAME_MAX_ROWS][LCD_FRAME_MAX_COLS];
+
+    // Hilfsfunktionen
+    void setHardwareCursor(uint8_t col, uint8_t row);
+};
+
+#endif // LCD_FRAME_BUFFER_H
@@ -0,0 +1,130 @@
+/**
+ * @file LinkHealth.cpp
+ * @brief Backoff and circuit breaker for one bus participant
+ *
+ * A failed access postpones the next one: first by the normal poll
+ * interval, then twice as long after every further failure, up to
+ * backoffMax. After tripFailures failures in a row the participant
+ * counts as dead (LINK_OPEN) and is only probed every probeInterval;
+ * the first success closes the breaker again. A silent Modbus slave
+ * thus costs one response timeout per probe instead of one per poll.
+ *
+ * Like SensorCore, nothing here touches Arduino or FreeRTOS, so the
+ * same code runs in the native benchmark build (bench/).
+ *
+ * @author Johannes
+ * @version 1.0
+ * @date 2025
+ */
+
+#include "LinkHealth.h"
+
+/**
+ * @brief Constructor - Healthy, no accesses counted
+ */
+LinkHealth::LinkHealth() {
+    _state = LINK_OK;
+    _retryAt = 0;
+    _consecutive = 0;
+    _successes = 0;
+    _failures = 0;
+    _trips = 0;
+}
+
+/**
+ * @brief Check whether the next access is allowed
+ *
+ * @param now Current time in ms (millis(), wrap-around safe)
+ * @return true if healthy or the wait time after the last failure is over
+ */
+bool LinkHealth::due(uint32_t now) const {
+    return _state == LINK_OK || (int32_t)(now - _retryAt) >= 0;
+}
+
+void LinkHealth::recordSuccess() {
+    _state = LINK_OK;
+    _consecutive = 0;
+    _successes++;
+}
+
+/**
+ * @brief Record a failed access and compute the wait time
+ *
+ * @param now Time of the failure in ms (millis())
+ * @param interval Normal poll interval in ms
+ * @param policy Backoff and breaker limits
+ * @return uint32_t Time until the next access in ms
+ */
+uint32_t LinkHealth::recordFailure(uint32_t now, uint32_t interval, const LinkPolicy &policy) {
+    _failures++;
+    _consecutive++;
+
+    uint32_t wait;
+    if (_consecutive >= policy.tripFailures) {
+        if (_state != LINK_OPEN) {
+            _trips++;
+        }
+        _state = LINK_OPEN;
+        wait = policy.probeInterval;
+    } else {
+        _state = LINK_BACKOFF;
+        uint8_t shift = _consecutive - 1 < 16 ? _consecutive - 1 : 16;
+        uint64_t backoff = (uint64_t)interval << shift;
+        wait = backoff < policy.backoffMax ? (uint32_t)backoff : policy.backoffMax;
+        if (wait < interval) {
+            wait = interval;
+        }
+    }
+
+    _retryAt = now + wait;
+    return wait;
+}
+
+LinkState LinkHealth::state() const {
+    return _state;
+}
+
+uint32_t LinkHealth::consecutiveFailures() const {
+    return _consecutive;
+}
+
+uint32_t LinkHealth::successes() const {
+    return _successes;
+}
+
+uint32_t LinkHealth::failures() const {
+    return _failures;
+}
+
+uint32_t LinkHealth::trips() const {
+    return _trips;
+}
+
+/**
+ * @brief State and counters as a plain struct (for SnapshotBuffer)
+ */
+LinkStats LinkHealth::stats() const {
+    LinkStats stats;
+    stats.state = _state;
+    stats.consecutive = _consecutive;
+    stats.successes = _successes;
+    stats.failures = _failures;
+    stats.trips = _trips;
+    return stats;
+}
+
+/**
+ * @brief Name of a link state for the API and the metrics
+ */
+const char *linkStateName(LinkState state) {
+    switch (state) {
+    case LINK_OK:
+        return "ok";
+    case LINK_BACKOFF:
+        return "backoff";
+    case LINK_OPEN:
+        return "open";
+    default:
+        return "unknown";
+    }
+}
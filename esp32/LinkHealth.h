@@ -0,0 +1,65 @@
+#ifndef LINK_HEALTH_H
+#define LINK_HEALTH_H
+
+// Fehlerzustand einer Gegenstelle am Bus (Gerät oder Kanal, auch nativ übersetzbar)
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Zustand
+enum LinkState : uint8_t {
+    LINK_OK,      // Letzter Zugriff erfolgreich
+    LINK_BACKOFF, // Fehler, nächster Versuch nach wachsender Wartezeit
+    LINK_OPEN     // Abgeschaltet, nur noch Prüfanfragen im Abstand probeInterval
+};
+
+// Regeln für Wartezeit und Abschaltung
+struct LinkPolicy {
+    uint32_t backoffMax;    // Längste Wartezeit im Zustand LINK_BACKOFF in ms
+    uint8_t tripFailures;   // Aufeinanderfolgende Fehler bis LINK_OPEN
+    uint32_t probeInterval; // Abstand der Prüfanfragen im Zustand LINK_OPEN in ms
+};
+
+// Kopierbarer Auszug für Snapshots und Metriken
+struct LinkStats {
+    LinkState state;
+    uint32_t consecutive; // Aufeinanderfolgende Fehler
+    uint32_t successes;
+    uint32_t failures;
+    uint32_t trips;
+};
+
+class LinkHealth {
+public:
+    // Konstruktor (LINK_OK, alle Zähler 0)
+    LinkHealth();
+
+    // Darf zum Zeitpunkt now (ms) zugegriffen werden?
+    bool due(uint32_t now) const;
+
+    // Ergebnis eines Zugriffs melden
+    void recordSuccess();
+    // interval: normales Abfrageintervall; Rückgabe: Wartezeit bis zum nächsten Versuch in ms
+    uint32_t recordFailure(uint32_t now, uint32_t interval, const LinkPolicy &policy);
+
+    // Zustand und Zähler
+    LinkState state() const;
+    uint32_t consecutiveFailures() const;
+    uint32_t successes() const;
+    uint32_t failures() const;
+    uint32_t trips() const; // Wechsel nach LINK_OPEN
+    LinkStats stats() const;
+
+private:
+    LinkState _state;
+    uint32_t _retryAt; // Frühester nächster Versuch (millis())
+    uint32_t _consecutive;
+    uint32_t _successes;
+    uint32_t _failures;
+    uint32_t _trips;
+};
+
+// Name eines Zustands für API und Metriken ("ok", "backoff", "open")
+const char *linkStateName(LinkState state);
+
+#endif // LINK_HEALTH_H
@@ -0,0 +1,121 @@
+/**
+ * @file Metrics.cpp
+ * @brief Lightweight latency histograms for hot-path instrumentation
+ *
+ * Recording a value costs a few relaxed atomic increments and no
+ * allocation, so histograms can stay enabled around Modbus
+ * transactions and in the main loop. Bucket boundaries are fixed at
+ * compile time and cover 100 us to 1 s, which spans display flushes,
+ * web handlers and Modbus timeouts alike.
+ *
+ * Output follows the Prometheus text exposition format:
+ * cumulative "_bucket" series with an "le" label, "_sum" and "_count".
+ *
+ * @author Johannes
+ * @version 1.0
+ * @date 2025
+ */
+
+#include "Metrics.h"
+
+const uint32_t LatencyHistogram::bounds[METRICS_BUCKETS - 1] = {
+    100, 250, 500, 1000, 2500, 5000, 10000,
+    25000, 50000, 100000, 250000, 500000, 1000000};
+
+/**
+ * @brief Constructor - All buckets empty
+ */
+LatencyHistogram::LatencyHistogram() {
+    for (int i = 0; i < METRICS_BUCKETS; i++) {
+        _buckets[i].store(0, std::memory_order_relaxed);
+    }
+    _count.store(0, std::memory_order_relaxed);
+    _sum.store(0, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Record one measurement
+ *
+ * @param micros Duration in microseconds
+ */
+void LatencyHistogram::record(uint32_t micros) {
+    int bucket = 0;
+    while (bucket < METRICS_BUCKETS - 1 && micros > bounds[bucket]) {
+        bucket++;
+    }
+
+    _buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(micros, std::memory_order_relaxed);
+
+    // Single writer: a plain compare is sufficient
+    if (micros > _max.load(std::memory_order_relaxed)) {
+        _max.store(micros, std::memory_order_relaxed);
+    }
+}
+
+uint32_t LatencyHistogram::count() const {
+    return _count.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Sum of all measurements in microseconds
+ */
+uint64_t LatencyHistogram::sum() const {
+    return _sum.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Largest measurement since boot in microseconds
+ */
+uint32_t LatencyHistogram::maximum() const {
+    return _max.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Print the histogram in Prometheus text format
+ *
+ * Values are converted to seconds, the Prometheus base unit.
+ *
+ * @param out Output stream (e.g. AsyncResponseStream)
+ * @param name Metric name without suffix
+ * @param labels Additional labels without braces (e.g. "handler=\"status\""), or empty
+ */
+void LatencyHistogram::printPrometheus(Print &out, const char *name, const char *labels) const {
+    const char *separator = labels[0] ? "," : "";
+    uint32_t cumulative = 0;
+
+    for (int i = 0; i < METRICS_BUCKETS; i++) {
+        cumulative += _buckets[i].load(std::memory_order_relaxed);
+
+        out.printf("%s_bucket{%s%sle=\"", name, labels, separator);
+        if (i < METRICS_BUCKETS - 1) {
+            out.printf("%lu.%06lu", (unsigned long)(bounds[i] / 1000000), (unsigned long)(bounds[i] % 1000000));
+        } else {
+            out.print("+Inf");
+        }
+        out.printf("\"} %lu\n", (unsigned long)cumulative);
+    }
+
+    uint64_t total = sum();
+    out.printf("%s_sum{%s} %lu.%06lu\n", name, labels,
+               (unsigned long)(total / 1000000), (unsigned long)(total % 1000000));
+    out.printf("%s_count{%s} %lu\n", name, labels, (unsigned long)count());
+}
+
+/**
+ * @brief Print one counter or gauge sample in Prometheus text format
+ *
+ * @param out Output stream
+ * @param name Metric name
+ * @param labels Labels without braces, or empty
+ * @param value Sample value
+ */
+void printPrometheusCounter(Print &out, const char *name, const char *labels, uint64_t value) {
+    if (labels[0]) {
+        out.printf("%s{%s} %llu\n", name, labels, (unsigned long long)value);
+    } else {
+        out.printf("%s %llu\n", name, (unsigned long long)value);
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_timer.h>
+
+// Anzahl Histogramm-Buckets (inkl. +Inf)
+#define METRICS_BUCKETS 14
+
+// Latenz-Histogramm mit festen Bucket-Grenzen in Mikrosekunden
+// Schreiben: genau ein Task pro Histogramm, Lesen: beliebig
+class LatencyHistogram {
+public:
+    // Konstruktor
+    LatencyHistogram();
+
+    // Messwert erfassen
+    void record(uint32_t micros);
+
+    // Auswertung
+    uint32_t count() const;
+    uint64_t sum() const;
+    uint32_t maximum() const;
+
+    // Ausgabe im Prometheus-Textformat (Basiseinheit Sekunden)
+    void printPrometheus(Print &out, const char *name, const char *labels) const;
+
+    // Obere Bucket-Grenzen in Mikrosekunden (letzter Bucket = +Inf)
+    static const uint32_t bounds[METRICS_BUCKETS - 1];
+
+private:
+    std::atomic<uint32_t> _buckets[METRICS_BUCKETS];
+    std::atomic<uint32_t> _count;
+    std::atomic<uint64_t> _sum;
+    std::atomic<uint32_t> _max;
+};
+
+// Misst die Laufzeit eines Blocks (Konstruktor bis Destruktor)
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyHistogram &histogram)
+        : _histogram(histogram), _start(esp_timer_get_time()) {}
+
+    ~ScopedLatency() {
+        _histogram.record((uint32_t)(esp_timer_get_time() - _start));
+    }
+
+private:
+    LatencyHistogram &_histogram;
+    int64_t _start;
+};
+
+// Zähler im Prometheus-Textformat ausgeben
+void printPrometheusCounter(Print &out, const char *name, const char *labels, uint64_t value);
+
+#endif // METRICS_H
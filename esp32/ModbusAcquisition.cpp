@@ -0,0 +1,187 @@
+/**
+ * @file ModbusAcquisition.cpp
+ * @brief Reading the channels of one Modbus device per poll cycle
+ *
+ * A device is normally read with one block request covering the
+ * registers of all its channels. Only an exception response to that
+ * request (the module refuses large reads) switches the device to one
+ * request per channel for good; a garbled block response is followed
+ * by single reads for the current cycle, a timeout by nothing. In
+ * single mode every channel keeps its own LinkHealth, so an unplugged
+ * probe does not cost a timeout in every cycle. A cycle without any
+ * successful read counts against the device's LinkHealth, a cycle in
+ * which every channel was still backing off (no request) does not.
+ *
+ * Garbled responses (CRC error, wrong slave ID or function code) prove
+ * the slave is alive and are repeated right away; timeouts and
+ * exception responses never are.
+ *
+ * Only ModbusTransport is used, so the firmware (ModbusMaster) and the
+ * native benchmark (SimulatedBus) run the same code.
+ *
+ * @author Johannes
+ * @version 1.0
+ * @date 2025
+ */
+
+#include "ModbusAcquisition.h"
+
+/**
+ * @brief Constructor
+ *
+ * @param transport Bus access (used for every request)
+ * @param policy Backoff and breaker limits of devices and channels
+ * @param retries Immediate retries of a garbled response
+ */
+ModbusAcquisition::ModbusAcquisition(ModbusTransport &transport, const LinkPolicy &policy, uint8_t retries)
+    : _transport(transport), _policy(policy) {
+    _maxRetries = retries;
+    _retries = 0;
+}
+
+/**
+ * @brief Read registers with immediate retries of garbled responses
+ *
+ * @param device Device to read from
+ * @param address First register
+ * @param count Number of registers
+ * @param words Output buffer (untouched on error)
+ * @return uint8_t MODBUS_RESULT_* of the last attempt
+ */
+uint8_t ModbusAcquisition::readRegisters(const AcquisitionDevice &device, uint16_t address, uint16_t count,
+                                         uint16_t *words) {
+    for (int attempt = 0;; attempt++) {
+        uint8_t result = _transport.readRegisters(device.slaveId, device.registerType, address, count, words);
+
+        bool garbled = (result == MODBUS_RESULT_INVALID_CRC || result == MODBUS_RESULT_INVALID_SLAVE_ID ||
+                        result == MODBUS_RESULT_INVALID_FUNCTION);
+        if (!garbled || attempt >= _maxRetries) {
+            return result;
+        }
+        _retries++;
+    }
+}
+
+/**
+ * @brief Read the channels of a device with one request per channel
+ *
+ * Channels whose LinkHealth is not due are skipped (valid stays false).
+ *
+ * @param requests Incremented for every channel actually requested
+ * @param lastError Set to the result of the last failed read (unchanged if none failed)
+ * @return uint8_t Number of channels read successfully
+ */
+uint8_t ModbusAcquisition::readSingle(const AcquisitionDevice &device, LinkHealth *channelHealth, uint32_t now,
+                                      uint32_t interval, float *values, bool *valid, uint8_t &requests,
+                                      uint8_t &lastError) {
+    uint8_t successCount = 0;
+
+    for (int i = 0; i < device.channelCount; i++) {
+        const SensorChannel &channel = device.channels[i];
+        if (!channelHealth[i].due(now)) {
+            continue;
+        }
+
+        uint16_t words[2];
+        uint8_t result = readRegisters(device, channel.registerAddress, channelRegisterCount(channel.format), words);
+        requests++;
+        if (result == MODBUS_RESULT_SUCCESS) {
+            values[i] = decodeChannelValue(channel, words);
+            valid[i] = true;
+            channelHealth[i].recordSuccess();
+            successCount++;
+        } else {
+            channelHealth[i].recordFailure(now, interval, _policy);
+            lastError = result;
+        }
+    }
+
+    return successCount;
+}
+
+/**
+ * @brief Run one poll cycle of a device
+ *
+ * In block mode the register range covering all channels is read in
+ * one transaction and every value is decoded from the response with
+ * its channel's decoder. This saves the request/response framing, the
+ * inter-frame silence and the RS485 turnaround for all but one channel.
+ *
+ * @param device Device to read
+ * @param link Block mode and LinkHealth of the device (updated)
+ * @param channelHealth LinkHealth per channel of the device (single reads)
+ * @param now Current time in ms (millis())
+ * @param interval Configured poll interval of the device in ms (backoff base)
+ * @param values Output array, one entry per channel (valid entries only)
+ * @param valid Output array, true for every channel read successfully
+ * @return DevicePoll What happened on the bus, for logging and metrics
+ */
+DevicePoll ModbusAcquisition::poll(const AcquisitionDevice &device, DeviceLink &link, LinkHealth *channelHealth,
+                                   uint32_t now, uint32_t interval, float *values, bool *valid) {
+    DevicePoll poll = {MODBUS_RESULT_SUCCESS, MODBUS_RESULT_SUCCESS, 0, 0, false, false};
+    bool single = !link.blockRead;
+    for (int i = 0; i < device.channelCount; i++) {
+        valid[i] = false;
+    }
+
+    if (link.blockRead) {
+        uint16_t words[ACQUISITION_MAX_REGISTERS];
+        poll.blockResult = readRegisters(device, device.firstRegister, device.registerCount, words);
+        poll.requests++;
+
+        if (poll.blockResult == MODBUS_RESULT_SUCCESS) {
+            decodeChannelBlock(device.channels, device.channelCount, device.firstRegister, words, values);
+            for (int i = 0; i < device.channelCount; i++) {
+                valid[i] = true;
+            }
+            poll.validCount = device.channelCount;
+        } else if (poll.blockResult == MODBUS_RESULT_ILLEGAL_FUNCTION ||
+                   poll.blockResult == MODBUS_RESULT_ILLEGAL_DATA_ADDRESS ||
+                   poll.blockResult == MODBUS_RESULT_ILLEGAL_DATA_VALUE) {
+            // Exception response: the slave answered but refuses the request
+            link.blockRead = false;
+            poll.blockDisabled = true;
+            single = true;
+        } else {
+            // Garbled: read singly this cycle; timeout: the slave is silent
+            single = (poll.blockResult != MODBUS_RESULT_TIMEOUT);
+        }
+    }
+
+    if (single) {
+        poll.validCount = readSingle(device, channelHealth, now, interval, values, valid, poll.requests,
+                                     poll.channelError);
+    }
+
+    // Nothing sent (all channels backing off): no verdict on the device
+    if (poll.validCount > 0) {
+        link.health.recordSuccess();
+    } else if (poll.requests > 0) {
+        LinkState before = link.health.state();
+        link.retryWait = link.health.recordFailure(now, interval, _policy);
+        poll.tripped = (link.health.state() == LINK_OPEN && before != LINK_OPEN);
+    }
+
+    return poll;
+}
+
+/**
+ * @brief Check whether a device answers at the current bus speed
+ *
+ * Reads the first channel. An exception response proves the speed
+ * too, only the register is wrong.
+ *
+ * @param device Device to try
+ * @return true if the device sent a valid frame
+ */
+bool ModbusAcquisition::answers(const AcquisitionDevice &device) {
+    const SensorChannel &channel = device.channels[0];
+    uint16_t words[2];
+    uint8_t result = readRegisters(device, channel.registerAddress, channelRegisterCount(channel.format), words);
+    return result == MODBUS_RESULT_SUCCESS ||
+           (result >= MODBUS_RESULT_ILLEGAL_FUNCTION && result <= MODBUS_RESULT_SLAVE_DEVICE_FAILURE);
+}
+
+uint32_t ModbusAcquisition::retries() const {
+    return _retries;
+}
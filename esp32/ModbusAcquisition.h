@@ -0,0 +1,73 @@
+#ifndef MODBUS_ACQUISITION_H
+#define MODBUS_ACQUISITION_H
+
+// Abfrage der Modbus-Geräte über ModbusTransport: Block- oder Einzelabfragen,
+// Wiederholung gestörter Antworten, Fehlerzustand pro Gerät und Kanal (auch nativ übersetzbar)
+
+#include <stdint.h>
+#include "SensorCore.h"
+#include "LinkHealth.h"
+#include "ModbusTransport.h"
+
+// Größte Blockabfrage in Registern (Antwortpuffer von ModbusMaster)
+#define ACQUISITION_MAX_REGISTERS 64
+
+// Gerät am Bus mit seinem Ausschnitt der Kanaltabelle
+struct AcquisitionDevice {
+    uint8_t slaveId;
+    ModbusRegisterType registerType;
+    const SensorChannel *channels; // Erster Kanal des Geräts (Kanäle folgen lückenlos)
+    uint8_t channelCount;
+    uint16_t firstRegister;        // Erstes Register der Blockabfrage
+    uint16_t registerCount;        // Register der Blockabfrage (bis ACQUISITION_MAX_REGISTERS)
+};
+
+// Abfragezustand eines Geräts (gehört dem Erfassungstask)
+struct DeviceLink {
+    bool blockRead;     // Blockabfrage aktiv (aus nach einer Exception-Antwort)
+    LinkHealth health;  // Backoff / Abschaltung des Geräts
+    uint32_t retryWait; // Wartezeit nach dem letzten fehlgeschlagenen Zyklus in ms
+};
+
+// Ergebnis eines Abfragezyklus
+struct DevicePoll {
+    uint8_t blockResult;  // MODBUS_RESULT_* der Blockabfrage (SUCCESS ohne Blockabfrage)
+    uint8_t channelError; // Letzter Fehler einer Einzelabfrage (SUCCESS = keiner)
+    uint8_t validCount;   // Erfolgreich gelesene Kanäle
+    uint8_t requests;     // Gesendete Anfragen (0 = alle Kanäle im Backoff)
+    bool blockDisabled;   // Blockabfrage in diesem Zyklus abgeschaltet
+    bool tripped;         // Gerät in diesem Zyklus nach LINK_OPEN gewechselt
+};
+
+class ModbusAcquisition {
+public:
+    // retries: sofortige Wiederholungen einer gestörten Antwort (CRC, Slave-ID, Funktion)
+    ModbusAcquisition(ModbusTransport &transport, const LinkPolicy &policy, uint8_t retries);
+
+    // Register lesen; Rückgabe: MODBUS_RESULT_* des letzten Versuchs
+    uint8_t readRegisters(const AcquisitionDevice &device, uint16_t address, uint16_t count,
+                          uint16_t *words);
+
+    // Ein Zyklus eines Geräts zum Zeitpunkt now (ms); interval: Abfrageintervall in ms
+    // channelHealth, values, valid: ein Eintrag pro Kanal des Geräts
+    DevicePoll poll(const AcquisitionDevice &device, DeviceLink &link, LinkHealth *channelHealth,
+                    uint32_t now, uint32_t interval, float *values, bool *valid);
+
+    // Antwortet das Gerät (erster Kanal)? Eine Exception-Antwort zählt als Antwort
+    bool answers(const AcquisitionDevice &device);
+
+    // Wiederholungen gestörter Antworten seit dem Start
+    uint32_t retries() const;
+
+private:
+    uint8_t readSingle(const AcquisitionDevice &device, LinkHealth *channelHealth, uint32_t now,
+                       uint32_t interval, float *values, bool *valid, uint8_t &requests,
+                       uint8_t &lastError);
+
+    ModbusTransport &_transport;
+    LinkPolicy _policy;
+    uint8_t _maxRetries;
+    uint32_t _retries;
+};
+
+#endif // MODBUS_ACQUISITION_H
@@ -0,0 +1,60 @@
+/**
+ * @file ModbusMasterTransport.h
+ * @brief ModbusTransport on top of the ModbusMaster library
+ *
+ * Switches ModbusMaster to the addressed slave (callbacks and serial
+ * port stay as configured), issues a read with function code 03 or 04
+ * and copies the registers out of the library's response buffer.
+ *
+ * @author Johannes
+ * @version 1.0
+ * @date 2025
+ */
+
+#ifndef MODBUS_MASTER_TRANSPORT_H
+#define MODBUS_MASTER_TRANSPORT_H
+
+#include <Arduino.h>
+#include <ModbusMaster.h>
+#include "ModbusTransport.h"
+
+static_assert(ModbusMaster::ku8MBSuccess == MODBUS_RESULT_SUCCESS &&
+                  ModbusMaster::ku8MBIllegalFunction == MODBUS_RESULT_ILLEGAL_FUNCTION &&
+                  ModbusMaster::ku8MBIllegalDataAddress == MODBUS_RESULT_ILLEGAL_DATA_ADDRESS &&
+                  ModbusMaster::ku8MBIllegalDataValue == MODBUS_RESULT_ILLEGAL_DATA_VALUE &&
+                  ModbusMaster::ku8MBSlaveDeviceFailure == MODBUS_RESULT_SLAVE_DEVICE_FAILURE &&
+                  ModbusMaster::ku8MBInvalidSlaveID == MODBUS_RESULT_INVALID_SLAVE_ID &&
+                  ModbusMaster::ku8MBInvalidFunction == MODBUS_RESULT_INVALID_FUNCTION &&
+                  ModbusMaster::ku8MBResponseTimedOut == MODBUS_RESULT_TIMEOUT &&
+                  ModbusMaster::ku8MBInvalidCRC == MODBUS_RESULT_INVALID_CRC,
+              "MODBUS_RESULT_* must match the ModbusMaster result codes");
+
+class ModbusMasterTransport : public ModbusTransport {
+public:
+    /**
+     * @param master Configured ModbusMaster instance
+     * @param serial Serial port the bus is connected to
+     */
+    ModbusMasterTransport(ModbusMaster &master, Stream &serial)
+        : _master(master), _serial(serial) {}
+
+    uint8_t readRegisters(uint8_t slaveId, ModbusRegisterType type, uint16_t address,
+                          uint16_t count, uint16_t *words) override {
+        _master.begin(slaveId, _serial);
+
+        uint8_t result = (type == INPUT_REGISTERS) ? _master.readInputRegisters(address, count)
+                                                   : _master.readHoldingRegisters(address, count);
+        if (result == ModbusMaster::ku8MBSuccess) {
+            for (uint16_t i = 0; i < count; i++) {
+                words[i] = _master.getResponseBuffer(i);
+            }
+        }
+        return result;
+    }
+
+private:
+    ModbusMaster &_master;
+    Stream &_serial;
+};
+
+#endif // MODBUS_MASTER_TRANSPORT_H
@@ -0,0 +1,30 @@
+#ifndef MODBUS_TRANSPORT_H
+#define MODBUS_TRANSPORT_H
+
+// Schnittstelle zum Modbus-Bus (Firmware: ModbusMaster, nativ: Simulation)
+
+#include <stdint.h>
+#include "SensorCore.h"
+
+// Ergebniscodes (identisch mit ModbusMaster ku8MB*)
+#define MODBUS_RESULT_SUCCESS 0x00
+#define MODBUS_RESULT_ILLEGAL_FUNCTION 0x01
+#define MODBUS_RESULT_ILLEGAL_DATA_ADDRESS 0x02
+#define MODBUS_RESULT_ILLEGAL_DATA_VALUE 0x03
+#define MODBUS_RESULT_SLAVE_DEVICE_FAILURE 0x04
+#define MODBUS_RESULT_INVALID_SLAVE_ID 0xE0
+#define MODBUS_RESULT_INVALID_FUNCTION 0xE1
+#define MODBUS_RESULT_TIMEOUT 0xE2
+#define MODBUS_RESULT_INVALID_CRC 0xE3
+
+class ModbusTransport {
+public:
+    virtual ~ModbusTransport() {}
+
+    // count Register ab address lesen (FC03/FC04), Ergebnis nach words
+    // Rückgabe: MODBUS_RESULT_*; words bleibt bei Fehlern unverändert
+    virtual uint8_t readRegisters(uint8_t slaveId, ModbusRegisterType type, uint16_t address,
+                                  uint16_t count, uint16_t *words) = 0;
+};
+
+#endif // MODBUS_TRANSPORT_H
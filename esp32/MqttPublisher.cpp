@@ -0,0 +1,150 @@
+/**
+ * @file MqttPublisher.cpp
+ * @brief Non-blocking MQTT output on top of the ESP-IDF MQTT client
+ *
+ * The ESP-IDF client (esp-mqtt) keeps the broker connection in its own
+ * task and reconnects on its own. publish() only enqueues a message in
+ * the client's outbox; the network write happens in the client task,
+ * so a slow or unreachable broker never blocks the caller on a socket.
+ *
+ * The outbox is bounded by outboxLimit bytes. QoS 0 messages leave the
+ * outbox once written, QoS 1 messages when the broker acknowledges
+ * them; while the broker lags, new messages beyond the limit are
+ * rejected and counted as dropped. Callers publishing state simply
+ * publish the newest state on their next attempt (coalescing).
+ *
+ * The availability topic is set to "online" (retained) on every
+ * connect and to "offline" by the broker through the Last Will.
+ *
+ * @author Johannes
+ * @version 1.0
+ * @date 2025
+ */
+
+#include "MqttPublisher.h"
+
+/**
+ * @brief Constructor - The client is created in begin()
+ */
+MqttPublisher::MqttPublisher()
+    : _connected(false), _connection(0), _published(0), _dropped(0) {
+    _client = nullptr;
+    _availabilityTopic[0] = '\0';
+    _outboxLimit = 0;
+}
+
+/**
+ * @brief Create the MQTT client
+ *
+ * @param uri Broker URI, e.g. "mqtt://192.168.1.10:1883"
+ * @param clientId MQTT client ID
+ * @param username User name (nullptr or "" = anonymous)
+ * @param password Password (nullptr or "" = none)
+ * @param availabilityTopic Topic for "online" / "offline" (Last Will)
+ * @param outboxLimit Maximum bytes waiting to be sent or acknowledged
+ * @return true if the client was created
+ */
+bool MqttPublisher::begin(const char *uri, const char *clientId, const char *username,
+                          const char *password, const char *availabilityTopic, size_t outboxLimit) {
+    strncpy(_availabilityTopic, availabilityTopic, sizeof(_availabilityTopic) - 1);
+    _availabilityTopic[sizeof(_availabilityTopic) - 1] = '\0';
+    _outboxLimit = outboxLimit;
+
+    // The client copies all strings of the configuration
+    esp_mqtt_client_config_t config = {};
+    config.broker.address.uri = uri;
+    config.credentials.client_id = clientId;
+    if (username != nullptr && username[0] != '\0') {
+        config.credentials.username = username;
+        config.credentials.authentication.password = password;
+    }
+    config.session.last_will.topic = _availabilityTopic;
+    config.session.last_will.msg = "offline";
+    config.session.last_will.msg_len = 7;
+    config.session.last_will.qos = 1;
+    config.session.last_will.retain = 1;
+
+    _client = esp_mqtt_client_init(&config);
+    if (_client == nullptr) {
+        return false;
+    }
+    esp_mqtt_client_register_event(_client, MQTT_EVENT_ANY, onEvent, this);
+    return true;
+}
+
+bool MqttPublisher::start() {
+    return _client != nullptr && esp_mqtt_client_start(_client) == ESP_OK;
+}
+
+/**
+ * @brief Enqueue a message for the client task
+ *
+ * @param topic Topic
+ * @param payload Message body
+ * @param length Length of the body in bytes
+ * @param qos 0 or 1
+ * @param retain Keep the message on the broker for new subscribers
+ * @return true if the message was accepted
+ */
+bool MqttPublisher::publish(const char *topic, const char *payload, size_t length, uint8_t qos,
+                            bool retain) {
+    if (!_connected) {
+        return false;
+    }
+
+    if (outboxBytes() + length > _outboxLimit) {
+        _dropped++;
+        return false;
+    }
+
+    if (esp_mqtt_client_enqueue(_client, topic, payload, length, qos, retain, true) < 0) {
+        _dropped++;
+        return false;
+    }
+    _published++;
+    return true;
+}
+
+bool MqttPublisher::connected() const {
+    return _connected;
+}
+
+uint32_t MqttPublisher::connection() const {
+    return _connection;
+}
+
+uint32_t MqttPublisher::published() const {
+    return _published;
+}
+
+uint32_t MqttPublisher::dropped() const {
+    return _dropped;
+}
+
+size_t MqttPublisher::outboxBytes() const {
+    if (_client == nullptr) {
+        return 0;
+    }
+    int size = esp_mqtt_client_get_outbox_size(_client);
+    return size > 0 ? size : 0;
+}
+
+/**
+ * @brief Connection events of the client task
+ */
+void MqttPublisher::onEvent(void *arg, esp_event_base_t base, int32_t eventId, void *eventData) {
+    MqttPublisher *self = static_cast<MqttPublisher *>(arg);
+
+    switch (eventId) {
+    case MQTT_EVENT_CONNECTED:
+        esp_mqtt_client_enqueue(self->_client, self->_availabilityTopic, "online", 6, 1, 1, true);
+        self->_connected = true;
+        self->_connection++;
+        break;
+    case MQTT_EVENT_DISCONNECTED:
+        self->_connected = false;
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef MQTT_PUBLISHER_H
+#define MQTT_PUBLISHER_H
+
+#include <Arduino.h>
+#include <mqtt_client.h>
+#include <atomic>
+
+class MqttPublisher {
+public:
+    // Konstruktor
+    MqttPublisher();
+
+    // Client anlegen (Zeichenketten werden kopiert); verbindet erst nach start()
+    // availabilityTopic: "online"/"offline" (retained, offline als Last Will)
+    // outboxLimit: Obergrenze der noch nicht gesendeten/bestätigten Bytes
+    bool begin(const char *uri, const char *clientId, const char *username, const char *password,
+               const char *availabilityTopic, size_t outboxLimit);
+
+    // Verbindung aufbauen (nach der ersten IP-Adresse; Wiederverbindung automatisch)
+    bool start();
+
+    // Nachricht an den MQTT-Task übergeben, blockiert nicht auf das Netzwerk
+    // false = nicht verbunden oder Outbox voll (Nachricht verworfen)
+    bool publish(const char *topic, const char *payload, size_t length, uint8_t qos, bool retain);
+
+    // Zustand
+    bool connected() const;
+    uint32_t connection() const; // Zählt jede erfolgreiche Verbindung (0 = noch nie)
+
+    // Statistik
+    uint32_t published() const;
+    uint32_t dropped() const;
+    size_t outboxBytes() const;
+
+private:
+    esp_mqtt_client_handle_t _client;
+    char _availabilityTopic[64];
+    size_t _outboxLimit;
+
+    std::atomic<bool> _connected;
+    std::atomic<uint32_t> _connection;
+    std::atomic<uint32_t> _published;
+    std::atomic<uint32_t> _dropped;
+
+    static void onEvent(void *arg, esp_event_base_t base, int32_t eventId, void *eventData);
+};
+
+#endif // MQTT_PUBLISHER_H
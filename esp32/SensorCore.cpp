@@ -0,0 +1,210 @@
+/**
+ * @file SensorCore.cpp
+ * @brief Hardware-independent processing of sensor readings
+ *
+ * Decoding of Modbus register values, conversion into the fixed-point
+ * channel record and text formatting. Nothing here touches Arduino,
+ * FreeRTOS or the bus, so the same code runs in the firmware and in
+ * the native benchmark build (bench/).
+ *
+ * @author Johannes
+ * @version 1.0
+ * @date 2025
+ */
+
+#include "SensorCore.h"
+#include <math.h>
+
+/**
+ * @brief Convert two Modbus registers into a 32-bit float
+ *
+ * First register contains the high word, second the low word
+ * (Big Endian word order).
+ *
+ * @param highWord Register holding the upper 16 bits
+ * @param lowWord Register holding the lower 16 bits
+ * @return float Decoded value
+ */
+float decodeModbusFloat(uint16_t highWord, uint16_t lowWord) {
+    union {
+        uint32_t i;
+        float f;
+    } converter;
+
+    converter.i = ((uint32_t)highWord << 16) | lowWord;
+    return converter.f;
+}
+
+// Channel decoders, one per ChannelFormat
+// Each takes the channel's registers in bus order and returns the raw
+// value; no format checks happen per sample.
+
+static float decodeFloatABCD(const uint16_t *words) {
+    return decodeModbusFloat(words[0], words[1]);
+}
+
+static float decodeFloatCDAB(const uint16_t *words) {
+    return decodeModbusFloat(words[1], words[0]);
+}
+
+static float decodeFloatBADC(const uint16_t *words) {
+    return decodeModbusFloat(__builtin_bswap16(words[0]), __builtin_bswap16(words[1]));
+}
+
+static float decodeFloatDCBA(const uint16_t *words) {
+    return decodeModbusFloat(__builtin_bswap16(words[1]), __builtin_bswap16(words[0]));
+}
+
+static float decodeInt16(const uint16_t *words) {
+    return (int16_t)words[0];
+}
+
+static float decodeUInt16(const uint16_t *words) {
+    return words[0];
+}
+
+static float decodeInt32(const uint16_t *words) {
+    return (int32_t)(((uint32_t)words[0] << 16) | words[1]);
+}
+
+const ChannelDecoder CHANNEL_DECODERS[FORMAT_COUNT] = {
+    decodeFloatABCD, // FORMAT_FLOAT_ABCD
+    decodeFloatCDAB, // FORMAT_FLOAT_CDAB
+    decodeFloatBADC, // FORMAT_FLOAT_BADC
+    decodeFloatDCBA, // FORMAT_FLOAT_DCBA
+    decodeInt16,     // FORMAT_INT16
+    decodeUInt16,    // FORMAT_UINT16
+    decodeInt32,     // FORMAT_INT32
+};
+
+/**
+ * @brief Decode the value of a channel
+ *
+ * Applies the channel's decoder and scale.
+ *
+ * @param channel Channel map entry
+ * @param words The channel's registers
+ * @return float Value in °C
+ */
+float decodeChannelValue(const SensorChannel &channel, const uint16_t *words) {
+    return CHANNEL_DECODERS[channel.format](words) * channel.scale;
+}
+
+/**
+ * @brief Decode all channels of a block read
+ *
+ * @param channels Consecutive channel map entries of one device
+ * @param count Number of channels
+ * @param firstRegister Register address of words[0]
+ * @param words Registers of the block read
+ * @param values Output, one value per channel in °C
+ */
+void decodeChannelBlock(const SensorChannel *channels, uint8_t count, uint16_t firstRegister,
+                        const uint16_t *words, float *values) {
+    for (uint8_t i = 0; i < count; i++) {
+        values[i] = decodeChannelValue(channels[i], words + (channels[i].registerAddress - firstRegister));
+    }
+}
+
+/**
+ * @brief Convert a raw reading into the fixed-point channel record
+ *
+ * A failed or implausible read keeps the last good value, flagged as
+ * stale while it is younger than holdTime.
+ *
+ * @param reading Channel record to update
+ * @param success Read was answered by the slave
+ * @param value Decoded value in °C (ignored if !success)
+ * @param offset Calibration offset in 0.01 °C
+ * @param now millis() of the read
+ * @param holdTime Time in ms a last good value is still reported
+ */
+void updateReading(SensorReading &reading, bool success, float value, int16_t offset,
+                   uint32_t now, uint32_t holdTime) {
+    uint8_t error = QUALITY_COMM_ERROR;
+
+    if (success) {
+        float centi = value * 100 + offset;
+        if (centi >= SENSOR_MIN_CENTI && centi <= SENSOR_MAX_CENTI) { // Also false for NaN
+            reading.centi = (int16_t)lrintf(centi);
+            reading.quality = QUALITY_OK;
+            reading.lastGood = now;
+            return;
+        }
+        error = QUALITY_OUT_OF_RANGE;
+    }
+
+    reading.quality = error;
+    if (reading.lastGood != 0 && now - reading.lastGood <= holdTime) {
+        reading.quality |= QUALITY_STALE;
+    }
+}
+
+/**
+ * @brief Check whether a reading carries a usable value
+ *
+ * @return true for current (QUALITY_OK) and stale values
+ */
+bool hasValue(const SensorReading &reading) {
+    return reading.quality & (QUALITY_OK | QUALITY_STALE);
+}
+
+/**
+ * @brief Round a reading to 0.1 °C (half away from zero)
+ */
+int16_t toDeci(int16_t centi) {
+    return centi >= 0 ? (centi + 5) / 10 : (centi - 5) / 10;
+}
+
+/**
+ * @brief Format a value in 0.1 °C as text with one decimal ("-12.3")
+ *
+ * Integer-only replacement for printf("%.1f"), used for JSON, HTML
+ * and LCD so all outputs round identically.
+ *
+ * @param deci Value in 0.1 °C
+ * @param out Buffer with at least 8 bytes
+ * @return size_t Text length
+ */
+size_t formatDeci(int16_t deci, char *out) {
+    char *p = out;
+    int value = deci;
+    if (value < 0) {
+        *p++ = '-';
+        value = -value;
+    }
+
+    // Integer digits in reverse, then copy
+    char digits[6];
+    int count = 0;
+    int whole = value / 10;
+    do {
+        digits[count++] = '0' + whole % 10;
+        whole /= 10;
+    } while (whole > 0);
+    while (count > 0) {
+        *p++ = digits[--count];
+    }
+
+    *p++ = '.';
+    *p++ = '0' + value % 10;
+    *p = '\0';
+    return p - out;
+}
+
+/**
+ * @brief Status name of a reading for the API
+ *
+ * @return const char* "ok", "stale", "comm_error", "out_of_range" or "no_data"
+ */
+const char *qualityName(uint8_t quality) {
+    if (quality & QUALITY_OK)
+        return "ok";
+    if (quality & QUALITY_STALE)
+        return "stale";
+    if (quality & QUALITY_COMM_ERROR)
+        return "comm_error";
+    if (quality & QUALITY_OUT_OF_RANGE)
+        return "out_of_range";
+    return "no_data";
+}
@@ -0,0 +1,82 @@
+#ifndef SENSOR_CORE_H
+#define SENSOR_CORE_H
+
+// Hardware-unabhängiger Kern der Messwertverarbeitung (auch nativ übersetzbar)
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Qualitätsbits eines Kanals
+#define QUALITY_OK 0x01           // Wert im letzten Zyklus erfolgreich gelesen
+#define QUALITY_STALE 0x02        // Letzter Lesevorgang fehlgeschlagen, Wert ist der letzte gute
+#define QUALITY_COMM_ERROR 0x04   // Letzter Lesevorgang am Bus fehlgeschlagen
+#define QUALITY_OUT_OF_RANGE 0x08 // Letzter Wert außerhalb SENSOR_MIN_CENTI..SENSOR_MAX_CENTI
+
+// Plausibler Messbereich in 0.01 °C (-200 °C bis 320 °C, int16-Grenze 327.67)
+#define SENSOR_MIN_CENTI -20000
+#define SENSOR_MAX_CENTI 32000
+
+// Messwert eines Kanals in Festkomma
+struct SensorReading {
+    int16_t centi;     // Letzter guter Wert in 0.01 °C
+    uint8_t quality;   // QUALITY_*-Bits (0 = nie gelesen)
+    uint32_t lastGood; // millis() des letzten guten Werts (0 = nie)
+};
+
+// Modbus-Registertabelle eines Geräts
+enum ModbusRegisterType : uint8_t {
+    HOLDING_REGISTERS, // Funktionscode 03
+    INPUT_REGISTERS    // Funktionscode 04
+};
+
+// Kodierung eines Kanalwerts in seinen Registern
+// Buchstaben = Bytes des Werts vom höchst- zum niederwertigsten, in der
+// Reihenfolge auf dem Bus (A = erstes gesendetes Byte)
+enum ChannelFormat : uint8_t {
+    FORMAT_FLOAT_ABCD, // 32-Bit-Float, Big Endian (High-Word zuerst)
+    FORMAT_FLOAT_CDAB, // 32-Bit-Float, Words vertauscht (Low-Word zuerst)
+    FORMAT_FLOAT_BADC, // 32-Bit-Float, Bytes innerhalb der Words vertauscht
+    FORMAT_FLOAT_DCBA, // 32-Bit-Float, Little Endian
+    FORMAT_INT16,      // Vorzeichenbehaftet 16 Bit, ein Register
+    FORMAT_UINT16,     // Vorzeichenlos 16 Bit, ein Register
+    FORMAT_INT32,      // Vorzeichenbehaftet 32 Bit, High-Word zuerst
+    FORMAT_COUNT
+};
+
+// Eintrag der Kanaltabelle
+struct SensorChannel {
+    uint8_t device;           // Eintrag in der Gerätetabelle
+    uint16_t registerAddress; // Erstes Register des Werts
+    ChannelFormat format;     // Kodierung des Werts
+    float scale;              // Faktor auf den dekodierten Wert (Ergebnis in °C)
+    const char *label;        // Standardname bis zur Umbenennung über die API
+};
+
+// Belegte Register eines Formats
+constexpr uint16_t channelRegisterCount(ChannelFormat format) {
+    return (format == FORMAT_INT16 || format == FORMAT_UINT16) ? 1 : 2;
+}
+
+// Dekoder: Register des Kanals in Busreihenfolge -> Rohwert
+typedef float (*ChannelDecoder)(const uint16_t *words);
+
+// Ein Dekoder pro ChannelFormat (Index = Format)
+extern const ChannelDecoder CHANNEL_DECODERS[FORMAT_COUNT];
+
+// Dekodieren
+float decodeModbusFloat(uint16_t highWord, uint16_t lowWord);
+float decodeChannelValue(const SensorChannel &channel, const uint16_t *words);
+void decodeChannelBlock(const SensorChannel *channels, uint8_t count, uint16_t firstRegister,
+                        const uint16_t *words, float *values);
+
+// Messwert übernehmen (Festkomma, Qualität, Haltezeit)
+void updateReading(SensorReading &reading, bool success, float value, int16_t offset,
+                   uint32_t now, uint32_t holdTime);
+
+// Formatierung
+bool hasValue(const SensorReading &reading);
+int16_t toDeci(int16_t centi);
+size_t formatDeci(int16_t deci, char *out);
+const char *qualityName(uint8_t quality);
+
+#endif // SENSOR_CORE_H
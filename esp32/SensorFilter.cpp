@@ -0,0 +1,215 @@
+/**
+ * @file SensorFilter.cpp
+ * @brief Per-channel filtering and rolling statistics in fixed point
+ *
+ * ChannelFilter rejects single-sample spikes with a short median and
+ * smooths the result with an exponential moving average; both work on
+ * the 0.01 °C integers of SensorReading, so no float math happens per
+ * sample. WindowAggregate keeps minimum, maximum and mean over a
+ * sliding time window in a fixed number of sub-windows (buckets):
+ * adding a value touches one bucket, a query merges all of them.
+ *
+ * Like SensorCore, nothing here touches Arduino or FreeRTOS, so the
+ * same code runs in the native benchmark build (bench/).
+ *
+ * @author Johannes
+ * @version 1.0
+ * @date 2025
+ */
+
+#include "SensorFilter.h"
+#include <string.h>
+
+/**
+ * @brief Check a filter setting from the configuration API
+ *
+ * @return true if the median window is odd and within FILTER_MAX_MEDIAN
+ *         and the smoothing within FILTER_MAX_SMOOTHING
+ */
+bool isValidFilterConfig(const FilterConfig &config) {
+    return config.median >= 1 && config.median <= FILTER_MAX_MEDIAN && (config.median & 1) &&
+           config.smoothing <= FILTER_MAX_SMOOTHING;
+}
+
+/**
+ * @brief Round a fixed-point value to the nearest integer (half away from zero)
+ *
+ * @param value Value in 1/2^shift units
+ * @param shift Fractional bits
+ */
+static int32_t roundShift(int32_t value, uint8_t shift) {
+    if (shift == 0) {
+        return value;
+    }
+    int32_t half = 1L << (shift - 1);
+    return value >= 0 ? (value + half) >> shift : -((-value + half) >> shift);
+}
+
+/**
+ * @brief Constructor - Filter disabled (median 1, no smoothing)
+ */
+ChannelFilter::ChannelFilter() {
+    _config.median = 1;
+    _config.smoothing = 0;
+    reset();
+}
+
+/**
+ * @brief Take over a filter setting
+ *
+ * Cheap enough to call every cycle; the history is only discarded when
+ * the setting actually changed.
+ *
+ * @param config New setting (checked with isValidFilterConfig())
+ */
+void ChannelFilter::configure(const FilterConfig &config) {
+    if (config.median != _config.median || config.smoothing != _config.smoothing) {
+        _config = config;
+        reset();
+    }
+}
+
+void ChannelFilter::reset() {
+    _count = 0;
+    _next = 0;
+    _ema = 0;
+    _emaValid = false;
+}
+
+/**
+ * @brief Filter one new raw value
+ *
+ * The median covers the last _config.median raw values (fewer right
+ * after a reset), so a single outlier never reaches the EMA. The EMA
+ * keeps 8 fractional bits to avoid the dead band a plain integer EMA
+ * has below 2^smoothing counts; its first value is taken as is.
+ *
+ * @param centi Raw value in 0.01 °C
+ * @return int16_t Filtered value in 0.01 °C
+ */
+int16_t ChannelFilter::apply(int16_t centi) {
+    int16_t value = centi;
+
+    if (_config.median > 1) {
+        _window[_next] = centi;
+        _next = (_next + 1) % _config.median;
+        if (_count < _config.median) {
+            _count++;
+        }
+
+        // Insertion sort of at most FILTER_MAX_MEDIAN values
+        int16_t sorted[FILTER_MAX_MEDIAN];
+        for (uint8_t i = 0; i < _count; i++) {
+            int16_t v = _window[i];
+            uint8_t j = i;
+            while (j > 0 && sorted[j - 1] > v) {
+                sorted[j] = sorted[j - 1];
+                j--;
+            }
+            sorted[j] = v;
+        }
+        value = sorted[_count / 2];
+    }
+
+    if (_config.smoothing == 0) {
+        return value;
+    }
+
+    int32_t scaled = (int32_t)value * 256;
+    if (!_emaValid) {
+        _ema = scaled;
+        _emaValid = true;
+    } else {
+        _ema += (scaled - _ema) / (1L << _config.smoothing);
+    }
+    return (int16_t)roundShift(_ema, 8);
+}
+
+/**
+ * @brief Constructor - No window yet, stats() reports no values
+ */
+WindowAggregate::WindowAggregate() {
+    begin(AGGREGATE_BUCKETS);
+}
+
+/**
+ * @brief Set the window length and discard all values
+ *
+ * @param windowMs Window length in ms (rounded down to a multiple of
+ *                 AGGREGATE_BUCKETS ms)
+ */
+void WindowAggregate::begin(uint32_t windowMs) {
+    _bucketMs = windowMs / AGGREGATE_BUCKETS;
+    if (_bucketMs == 0) {
+        _bucketMs = 1;
+    }
+    memset(_buckets, 0, sizeof(_buckets));
+}
+
+/**
+ * @brief Add a value
+ *
+ * Buckets are reused round-robin: a bucket whose slot is outdated is
+ * cleared before the value goes in.
+ *
+ * @param now Time of the value in ms (millis())
+ * @param centi Value in 0.01 °C
+ */
+void WindowAggregate::add(uint32_t now, int16_t centi) {
+    uint32_t slot = now / _bucketMs;
+    Bucket &bucket = _buckets[slot % AGGREGATE_BUCKETS];
+
+    if (bucket.slot != slot || bucket.count == 0) {
+        bucket.slot = slot;
+        bucket.sum = 0;
+        bucket.count = 0;
+        bucket.min = centi;
+        bucket.max = centi;
+    } else if (bucket.count == UINT16_MAX) {
+        return; // Sum would overflow, the bucket is representative anyway
+    }
+
+    bucket.sum += centi;
+    bucket.count++;
+    if (centi < bucket.min) {
+        bucket.min = centi;
+    }
+    if (centi > bucket.max) {
+        bucket.max = centi;
+    }
+}
+
+/**
+ * @brief Statistics of the current window
+ *
+ * Covers the bucket containing now and the AGGREGATE_BUCKETS - 1
+ * before it, i.e. between 11/12 and the full window length.
+ *
+ * @param now Current time in ms (millis())
+ * @return AggregateStats Minimum, maximum, rounded mean and value count
+ */
+AggregateStats WindowAggregate::stats(uint32_t now) const {
+    AggregateStats result = {0, 0, 0, 0};
+    uint32_t slot = now / _bucketMs;
+    int64_t sum = 0;
+
+    for (const Bucket &bucket : _buckets) {
+        if (bucket.count == 0 || slot - bucket.slot >= AGGREGATE_BUCKETS) {
+            continue;
+        }
+        if (result.count == 0 || bucket.min < result.min) {
+            result.min = bucket.min;
+        }
+        if (result.count == 0 || bucket.max > result.max) {
+            result.max = bucket.max;
+        }
+        sum += bucket.sum;
+        result.count += bucket.count;
+    }
+
+    if (result.count > 0) {
+        int64_t half = result.count / 2;
+        result.mean = (int16_t)(sum >= 0 ? (sum + half) / result.count : -((-sum + half) / result.count));
+    }
+    return result;
+}
@@ -0,0 +1,87 @@
+#ifndef SENSOR_FILTER_H
+#define SENSOR_FILTER_H
+
+// Glättung und gleitende Statistik pro Kanal in Festkomma (auch nativ übersetzbar)
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Längstes Medianfenster (ungerade)
+#define FILTER_MAX_MEDIAN 7
+
+// Stärkste Glättung (EMA mit alpha = 1/2^smoothing)
+#define FILTER_MAX_SMOOTHING 8
+
+// Teilfenster pro Statistikfenster (alte Werte fallen in Schritten von 1/12 heraus)
+#define AGGREGATE_BUCKETS 12
+
+// Filtereinstellung eines Kanals
+struct FilterConfig {
+    uint8_t median;    // Medianfenster in Werten (1 = aus, ungerade bis FILTER_MAX_MEDIAN)
+    uint8_t smoothing; // EMA mit alpha = 1/2^smoothing (0 = aus)
+};
+
+bool isValidFilterConfig(const FilterConfig &config);
+
+// Median gegen Ausreißer, danach EMA; alles in 0.01 °C
+class ChannelFilter {
+public:
+    // Konstruktor (Filter aus)
+    ChannelFilter();
+
+    // Einstellung übernehmen (bei einer Änderung beginnt der Filter neu)
+    void configure(const FilterConfig &config);
+
+    // Verlauf verwerfen, der nächste Wert wird unverändert übernommen
+    void reset();
+
+    // Neuen Rohwert filtern, liefert den geglätteten Wert
+    int16_t apply(int16_t centi);
+
+private:
+    FilterConfig _config;
+    int16_t _window[FILTER_MAX_MEDIAN]; // Letzte Rohwerte (Ringpuffer)
+    uint8_t _count;                     // Belegte Einträge
+    uint8_t _next;                      // Nächster Schreibplatz
+    int32_t _ema;                       // EMA in 1/256 von 0.01 °C
+    bool _emaValid;
+};
+
+// Ergebnis eines Statistikfensters (Werte in 0.01 °C)
+struct AggregateStats {
+    int16_t min;
+    int16_t max;
+    int16_t mean;
+    uint32_t count; // Werte im Fenster (0 = min/max/mean ungültig)
+};
+
+// Minimum, Maximum und Mittelwert über ein gleitendes Zeitfenster
+// Konstanter Speicher, O(1) pro Wert, O(AGGREGATE_BUCKETS) pro Abfrage
+class WindowAggregate {
+public:
+    // Konstruktor (leer, Fensterlänge über begin())
+    WindowAggregate();
+
+    // Fensterlänge in ms setzen und alle Werte verwerfen
+    void begin(uint32_t windowMs);
+
+    // Wert zum Zeitpunkt now (ms) hinzufügen
+    void add(uint32_t now, int16_t centi);
+
+    // Statistik der Werte der letzten Fensterlänge bis now
+    AggregateStats stats(uint32_t now) const;
+
+private:
+    struct Bucket {
+        uint32_t slot;   // now / _bucketMs des Teilfensters
+        int32_t sum;
+        uint16_t count;  // 0 = leer
+        int16_t min;
+        int16_t max;
+    };
+
+    uint32_t _bucketMs;
+    Bucket _buckets[AGGREGATE_BUCKETS];
+};
+
+#endif // SENSOR_FILTER_H
@@ -0,0 +1,315 @@
+/**
+ * @file SensorHistory.cpp
+ * @brief Fixed-size in-RAM history of sensor readings
+ *
+ * Rows of per-channel values (0.01 °C as int16) are stored in a ring of
+ * fixed-size blocks. Each block keeps the first row as absolute values
+ * and every further row as one signed byte per channel (difference to
+ * the previous row) plus a 16-bit offset into a shared timestamp
+ * column. A new block is started when a block is full, a difference
+ * does not fit into a byte, or the time offset would overflow. When
+ * the ring is full, the oldest block is overwritten.
+ *
+ * With 8 channels a row costs about 10.7 bytes instead of 20.
+ *
+ * Writers and readers are serialized with a FreeRTOS mutex; readers
+ * take it once per batch of rows (e.g. one HTTP response chunk).
+ *
+ * @author Johannes
+ * @version 1.0
+ * @date 2025
+ */
+
+#include "SensorHistory.h"
+
+// Delta value marking a missing reading
+#define HISTORY_NO_DELTA INT8_MIN
+
+/**
+ * @brief Constructor - No memory is reserved until begin()
+ */
+SensorHistory::SensorHistory() {
+    _storage = nullptr;
+    _blockSize = 0;
+    _blockCount = 0;
+    _channels = 0;
+    _psram = false;
+    _newestSerial = 0;
+    _mutex = nullptr;
+
+    for (int i = 0; i < HISTORY_MAX_CHANNELS; i++) {
+        _last[i] = HISTORY_NO_VALUE;
+    }
+}
+
+/**
+ * @brief Reserve the history memory
+ *
+ * @param channels Number of values per row (max HISTORY_MAX_CHANNELS)
+ * @param capacityBytes Memory to use for the ring of blocks
+ * @param usePsram Place the ring in PSRAM if the board has it
+ * @return true if the memory could be allocated
+ */
+bool SensorHistory::begin(uint8_t channels, size_t capacityBytes, bool usePsram) {
+    _channels = min(channels, (uint8_t)HISTORY_MAX_CHANNELS);
+
+    // Header + base values + time offsets + deltas, rounded to 4 bytes
+    _blockSize = sizeof(BlockHeader) + _channels * sizeof(int16_t) +
+                 HISTORY_BLOCK_ROWS * sizeof(uint16_t) + HISTORY_BLOCK_ROWS * _channels;
+    _blockSize = (_blockSize + 3) & ~(size_t)3;
+    _blockCount = capacityBytes / _blockSize;
+
+    if (_blockCount < 2) {
+        return false;
+    }
+
+    _psram = usePsram && psramFound();
+    if (_psram) {
+        _storage = (uint8_t *)ps_malloc(_blockCount * _blockSize);
+    } else {
+        _storage = (uint8_t *)malloc(_blockCount * _blockSize);
+    }
+
+    if (_storage == nullptr) {
+        _blockCount = 0;
+        return false;
+    }
+
+    memset(_storage, 0, _blockCount * _blockSize);
+    _mutex = xSemaphoreCreateMutex();
+    return true;
+}
+
+/**
+ * @brief Append one row
+ *
+ * @param time Timestamp in seconds (must not decrease)
+ * @param values One value per channel in 0.01 °C, HISTORY_NO_VALUE if missing
+ */
+void SensorHistory::append(uint32_t time, const int16_t *values) {
+    if (_storage == nullptr) {
+        return;
+    }
+
+    lock();
+
+    BlockHeader *header = _newestSerial ? block(_newestSerial) : nullptr;
+    if (header == nullptr || !fitsBlock(header, time, values)) {
+        startBlock(time, values);
+    } else {
+        uint8_t row = header->count;
+        timeOffsets(header)[row] = time - header->baseTime;
+
+        int8_t *delta = deltas(header, row);
+        for (uint8_t c = 0; c < _channels; c++) {
+            if (values[c] == HISTORY_NO_VALUE) {
+                delta[c] = HISTORY_NO_DELTA;
+            } else {
+                delta[c] = values[c] - _last[c];
+                _last[c] = values[c];
+            }
+        }
+        header->count++;
+    }
+
+    unlock();
+}
+
+void SensorHistory::lock() const {
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+}
+
+void SensorHistory::unlock() const {
+    xSemaphoreGive(_mutex);
+}
+
+/**
+ * @brief Position a cursor at the first block that may contain 'from'
+ *
+ * Rows before 'from' in that block are still returned by next() and
+ * have to be skipped by the caller. Requires lock().
+ *
+ * @param cursor Cursor to initialize
+ * @param from Earliest timestamp of interest
+ */
+void SensorHistory::seek(Cursor &cursor, uint32_t from) const {
+    cursor.row = 0;
+    cursor.block = _newestSerial + 1; // End position if nothing matches
+
+    if (_newestSerial == 0) {
+        return;
+    }
+
+    for (uint32_t serial = oldestSerial(); serial <= _newestSerial; serial++) {
+        BlockHeader *header = block(serial);
+        if (header == nullptr) {
+            continue;
+        }
+        uint32_t lastTime = header->baseTime + timeOffsets(header)[header->count - 1];
+        if (lastTime >= from) {
+            cursor.block = serial;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Decode the next row
+ *
+ * If the block under the cursor was overwritten in the meantime, the
+ * cursor continues at the oldest remaining block. Requires lock().
+ *
+ * @param cursor Cursor from seek()
+ * @param time Timestamp of the row
+ * @param values Output, one value per channel (HISTORY_NO_VALUE if missing)
+ * @return false if there are no more rows
+ */
+bool SensorHistory::next(Cursor &cursor, uint32_t &time, int16_t *values) const {
+    if (_newestSerial == 0) {
+        return false;
+    }
+
+    for (;;) {
+        uint32_t oldest = oldestSerial();
+        if (cursor.block < oldest) {
+            cursor.block = oldest;
+            cursor.row = 0;
+        }
+        if (cursor.block > _newestSerial) {
+            return false;
+        }
+
+        BlockHeader *header = block(cursor.block);
+        if (header == nullptr) {
+            return false;
+        }
+
+        if (cursor.row >= header->count) {
+            if (cursor.block == _newestSerial) {
+                return false;
+            }
+            cursor.block++;
+            cursor.row = 0;
+            continue;
+        }
+
+        time = header->baseTime + timeOffsets(header)[cursor.row];
+
+        if (cursor.row == 0) {
+            const int16_t *base = baseValues(header);
+            for (uint8_t c = 0; c < _channels; c++) {
+                cursor.running[c] = base[c];
+                values[c] = base[c];
+            }
+        } else {
+            const int8_t *delta = deltas(header, cursor.row);
+            for (uint8_t c = 0; c < _channels; c++) {
+                if (delta[c] == HISTORY_NO_DELTA) {
+                    values[c] = HISTORY_NO_VALUE;
+                } else {
+                    cursor.running[c] += delta[c];
+                    values[c] = cursor.running[c];
+                }
+            }
+        }
+
+        cursor.row++;
+        return true;
+    }
+}
+
+uint8_t SensorHistory::channels() const {
+    return _channels;
+}
+
+size_t SensorHistory::capacityRows() const {
+    return _blockCount * HISTORY_BLOCK_ROWS;
+}
+
+size_t SensorHistory::bytesPerRow() const {
+    return _blockSize / HISTORY_BLOCK_ROWS;
+}
+
+bool SensorHistory::usesPsram() const {
+    return _psram;
+}
+
+/**
+ * @brief Resolve a block serial number to its memory
+ * @return Block header, or nullptr if the block was overwritten
+ */
+SensorHistory::BlockHeader *SensorHistory::block(uint32_t serial) const {
+    if (serial == 0 || _blockCount == 0) {
+        return nullptr;
+    }
+    BlockHeader *header = (BlockHeader *)(_storage + ((serial - 1) % _blockCount) * _blockSize);
+    return header->serial == serial ? header : nullptr;
+}
+
+int16_t *SensorHistory::baseValues(BlockHeader *header) const {
+    return (int16_t *)((uint8_t *)header + sizeof(BlockHeader));
+}
+
+uint16_t *SensorHistory::timeOffsets(BlockHeader *header) const {
+    return (uint16_t *)((uint8_t *)baseValues(header) + _channels * sizeof(int16_t));
+}
+
+int8_t *SensorHistory::deltas(BlockHeader *header, uint8_t row) const {
+    return (int8_t *)((uint8_t *)timeOffsets(header) + HISTORY_BLOCK_ROWS * sizeof(uint16_t)) +
+           row * _channels;
+}
+
+uint32_t SensorHistory::oldestSerial() const {
+    if (_newestSerial <= _blockCount) {
+        return 1;
+    }
+    return _newestSerial - _blockCount + 1;
+}
+
+/**
+ * @brief Check whether a row can be delta-encoded into the current block
+ */
+bool SensorHistory::fitsBlock(const BlockHeader *header, uint32_t time, const int16_t *values) const {
+    if (header->count >= HISTORY_BLOCK_ROWS) {
+        return false;
+    }
+    if (time < header->baseTime || time - header->baseTime > UINT16_MAX) {
+        return false;
+    }
+
+    for (uint8_t c = 0; c < _channels; c++) {
+        if (values[c] == HISTORY_NO_VALUE) {
+            continue;
+        }
+        // A channel without a previous value needs an absolute base value
+        if (_last[c] == HISTORY_NO_VALUE) {
+            return false;
+        }
+        int32_t delta = (int32_t)values[c] - _last[c];
+        if (delta <= HISTORY_NO_DELTA || delta > INT8_MAX) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Start a new block with absolute values, overwriting the oldest one
+ */
+void SensorHistory::startBlock(uint32_t time, const int16_t *values) {
+    uint32_t serial = _newestSerial + 1;
+    BlockHeader *header = (BlockHeader *)(_storage + ((serial - 1) % _blockCount) * _blockSize);
+
+    header->serial = serial;
+    header->baseTime = time;
+    header->count = 1;
+
+    int16_t *base = baseValues(header);
+    for (uint8_t c = 0; c < _channels; c++) {
+        base[c] = values[c];
+        _last[c] = values[c];
+    }
+    timeOffsets(header)[0] = 0;
+
+    _newestSerial = serial;
+}
@@ -0,0 +1,77 @@
+#ifndef SENSOR_HISTORY_H
+#define SENSOR_HISTORY_H
+
+#include <Arduino.h>
+
+// Maximale Anzahl Kanäle pro Zeile
+#define HISTORY_MAX_CHANNELS 32
+
+// Zeilen pro Block (ein Block = absolute Basiswerte + Deltas)
+#define HISTORY_BLOCK_ROWS 32
+
+// Markierung für fehlende Werte
+#define HISTORY_NO_VALUE INT16_MIN
+
+class SensorHistory {
+public:
+    // Lese-Position (von seek() gesetzt, von next() weitergeschoben)
+    struct Cursor {
+        uint32_t block;                          // Laufende Blocknummer
+        uint8_t row;                             // Nächste Zeile im Block
+        int16_t running[HISTORY_MAX_CHANNELS];   // Dekodierte Werte der letzten Zeile
+    };
+
+    // Konstruktor
+    SensorHistory();
+
+    // Initialisierung (Speicher reservieren, optional im PSRAM)
+    bool begin(uint8_t channels, size_t capacityBytes, bool usePsram);
+
+    // Neue Zeile anhängen (Werte in 0.01 °C, HISTORY_NO_VALUE = kein Wert)
+    void append(uint32_t time, const int16_t *values);
+
+    // Lesezugriff: zwischen lock() und unlock() seek()/next() aufrufen
+    void lock() const;
+    void unlock() const;
+    void seek(Cursor &cursor, uint32_t from) const;
+    bool next(Cursor &cursor, uint32_t &time, int16_t *values) const;
+
+    // Statistik
+    uint8_t channels() const;
+    size_t capacityRows() const;
+    size_t bytesPerRow() const;
+    bool usesPsram() const;
+
+private:
+    // Blockkopf, danach folgen im Speicher:
+    //   int16_t base[channels]          absolute Werte der ersten Zeile
+    //   uint16_t offset[ROWS]           Zeitversatz zur Basiszeit (gemeinsame Zeitspalte)
+    //   int8_t delta[ROWS][channels]    Differenz zur vorherigen Zeile
+    struct BlockHeader {
+        uint32_t serial;   // Laufende Blocknummer (0 = leer)
+        uint32_t baseTime; // Zeitstempel der ersten Zeile
+        uint8_t count;     // Belegte Zeilen
+    };
+
+    uint8_t *_storage;
+    size_t _blockSize;
+    size_t _blockCount;
+    uint8_t _channels;
+    bool _psram;
+
+    uint32_t _newestSerial;                 // Aktueller Schreibblock (0 = keiner)
+    int16_t _last[HISTORY_MAX_CHANNELS];    // Letzter gültiger Wert pro Kanal im Schreibblock
+
+    SemaphoreHandle_t _mutex;
+
+    // Hilfsfunktionen
+    BlockHeader *block(uint32_t serial) const;
+    int16_t *baseValues(BlockHeader *header) const;
+    uint16_t *timeOffsets(BlockHeader *header) const;
+    int8_t *deltas(BlockHeader *header, uint8_t row) const;
+    uint32_t oldestSerial() const;
+    bool fitsBlock(const BlockHeader *header, uint32_t time, const int16_t *values) const;
+    void startBlock(uint32_t time, const int16_t *values);
+};
+
+#endif // SENSOR_HISTORY_H
@@ -0,0 +1,111 @@
+/**
+ * @file SensorRender.cpp
+ * @brief JSON and binary rendering of sensor readings
+ *
+ * Shared by the web handlers and the native benchmark build, so the
+ * serializers measured on the host are the ones running on the device.
+ * Callers pass readings and names as plain arrays and keep their own
+ * storage layout.
+ *
+ * @author Johannes
+ * @version 1.0
+ * @date 2025
+ */
+
+#include "SensorRender.h"
+#include <ArduinoJson.h>
+
+/**
+ * @brief Render the /api/v1/sensordata payload
+ *
+ * Format: {"sensors":[{"id":0,"name":"Sensor 1","value":23.5,"unit":"°C","status":"ok"},...]}
+ * "value" is null without a usable reading; sensors that are not "ok"
+ * also report "age", the seconds since their last good reading.
+ *
+ * @param readings One reading per sensor
+ * @param names One name per sensor
+ * @param count Number of sensors
+ * @param timestamp millis() the readings refer to
+ * @param out Destination buffer
+ * @param size Capacity of the buffer
+ * @return size_t Text length without terminator
+ */
+size_t renderSensorDataJson(const SensorReading *readings, const char *const *names, int count,
+                            uint32_t timestamp, char *out, size_t size) {
+    JsonDocument doc;
+    JsonArray sensors = doc.createNestedArray("sensors");
+
+    // Build JSON array with all sensor data
+    for (int i = 0; i < count; i++) {
+        JsonObject sensor = sensors.createNestedObject();
+        sensor["id"] = i;
+        sensor["name"] = names[i];
+        const SensorReading &reading = readings[i];
+        if (hasValue(reading)) {
+            // Written as text, no float arithmetic or rounding at render time
+            char text[8];
+            size_t length = formatDeci(toDeci(reading.centi), text);
+            sensor["value"] = serialized(text, length);
+        } else {
+            sensor["value"] = nullptr;
+        }
+        sensor["unit"] = "°C";
+        sensor["status"] = qualityName(reading.quality);
+        if (!(reading.quality & QUALITY_OK) && reading.lastGood != 0) {
+            sensor["age"] = (timestamp - reading.lastGood) / 1000;
+        }
+    }
+
+    return serializeJson(doc, out, size);
+}
+
+/**
+ * @brief Write a 16/32-bit value little endian, independent of the host
+ */
+static uint8_t *putLittleEndian(uint8_t *out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        *out++ = (uint8_t)(value >> (8 * i));
+    }
+    return out;
+}
+
+/**
+ * @brief Render the /api/v1/sensordata.bin payload
+ *
+ * Fixed layout for consumers polling at high rates, see SensorRender.h.
+ * Values are the same 0.01 °C integers the readings hold, so nothing
+ * is formatted here or parsed by the client. Sensors without a usable
+ * reading carry SENSOR_BINARY_NO_VALUE; the quality bits tell stale
+ * values from current ones.
+ *
+ * @param readings One reading per sensor
+ * @param count Number of sensors (max 255)
+ * @param timestamp millis() the readings refer to
+ * @param unixTime Wall-clock time of the readings, 0 if unknown
+ * @param out Destination buffer
+ * @param size Capacity of the buffer
+ * @return size_t Payload length, 0 if the buffer is too small
+ */
+size_t renderSensorDataBinary(const SensorReading *readings, int count, uint32_t timestamp,
+                              uint32_t unixTime, uint8_t *out, size_t size) {
+    if (count < 0 || count > 255 || size < (size_t)SENSOR_BINARY_SIZE(count)) {
+        return 0;
+    }
+
+    uint8_t *p = out;
+    *p++ = SENSOR_BINARY_VERSION;
+    *p++ = (uint8_t)count;
+    *p++ = SENSOR_BINARY_ENTRY_SIZE;
+    *p++ = 0;
+    p = putLittleEndian(p, timestamp, 4);
+    p = putLittleEndian(p, unixTime, 4);
+
+    for (int i = 0; i < count; i++) {
+        const SensorReading &reading = readings[i];
+        int16_t value = hasValue(reading) ? reading.centi : SENSOR_BINARY_NO_VALUE;
+        *p++ = (uint8_t)i;
+        *p++ = reading.quality;
+        p = putLittleEndian(p, (uint16_t)value, 2);
+    }
+    return p - out;
+}
@@ -0,0 +1,30 @@
+#ifndef SENSOR_RENDER_H
+#define SENSOR_RENDER_H
+
+// Ausgabe der Messwerte als JSON und Binärformat (auch nativ übersetzbar)
+
+#include <stddef.h>
+#include <stdint.h>
+#include "SensorCore.h"
+
+// Binärformat von /api/v1/sensordata.bin (little endian)
+//   Kopf:    uint8 version, uint8 count, uint8 entrySize, uint8 reserviert,
+//            uint32 timestamp (millis() der Messung), uint32 Unix-Zeit (0 = Uhr nicht gestellt)
+//   Eintrag: uint8 id, uint8 quality (QUALITY_*), int16 value (0.01 °C)
+#define SENSOR_BINARY_VERSION 1
+#define SENSOR_BINARY_HEADER_SIZE 12
+#define SENSOR_BINARY_ENTRY_SIZE 4
+#define SENSOR_BINARY_NO_VALUE INT16_MIN // Kein gültiger Wert
+#define SENSOR_BINARY_SIZE(count) (SENSOR_BINARY_HEADER_SIZE + (count) * SENSOR_BINARY_ENTRY_SIZE)
+
+// /api/v1/sensordata-Dokument in out schreiben (names: ein Zeiger pro Sensor)
+// Rückgabe: Textlänge ohne Terminator
+size_t renderSensorDataJson(const SensorReading *readings, const char *const *names, int count,
+                            uint32_t timestamp, char *out, size_t size);
+
+// /api/v1/sensordata.bin-Dokument in out schreiben
+// Rückgabe: Länge in Bytes (0 = Puffer zu klein)
+size_t renderSensorDataBinary(const SensorReading *readings, int count, uint32_t timestamp,
+                              uint32_t unixTime, uint8_t *out, size_t size);
+
+#endif // SENSOR_RENDER_H
@@ -0,0 +1,178 @@
+/**
+ * @file SensorSnapshot.h
+ * @brief Lock-free double-buffered snapshot for data shared between tasks
+ *
+ * A single writer publishes complete values into one of two slots while
+ * readers copy the other one. Every slot carries a sequence counter
+ * (seqlock): it is odd while the slot is being written, so a reader that
+ * raced with the writer detects the torn copy and simply retries.
+ * The writer never blocks and never takes a mutex.
+ *
+ * Requirements:
+ * - Only one task may call publish() at a time
+ * - T must be trivially copyable (plain arrays and numbers, no String)
+ *
+ * @author Johannes
+ * @version 1.0
+ * @date 2025
+ */
+
+#ifndef SENSOR_SNAPSHOT_H
+#define SENSOR_SNAPSHOT_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+template <typename T>
+class SnapshotBuffer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SnapshotBuffer requires a trivially copyable type");
+
+public:
+    SnapshotBuffer() : _latest(0) {
+        for (Slot &slot : _slots) {
+            slot.seq.store(0, std::memory_order_relaxed);
+            slot.version = 0;
+            memset(&slot.data, 0, sizeof(T));
+        }
+    }
+
+    /**
+     * @brief Publish a new value (single writer only)
+     *
+     * Writes into the slot that is not currently advertised as latest,
+     * then switches readers over to it.
+     *
+     * @param value New value to publish
+     */
+    void publish(const T &value) {
+        uint8_t current = _latest.load(std::memory_order_relaxed);
+        uint8_t next = current ^ 1;
+        Slot &slot = _slots[next];
+
+        uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+        slot.seq.store(seq + 1, std::memory_order_relaxed); // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+
+        memcpy(&slot.data, &value, sizeof(T));
+        slot.version = _slots[current].version + 1;
+
+        slot.seq.store(seq + 2, std::memory_order_release); // even: slot complete
+        _latest.store(next, std::memory_order_release);
+    }
+
+    /**
+     * @brief Publish a new value only if it differs from the latest one
+     *
+     * Compares the raw bytes, so unused parts of T should be zeroed by
+     * the caller. Keeps the version unchanged for identical content,
+     * which makes the version usable as a cache validator (ETag).
+     *
+     * @param value New value to publish
+     * @return true if the value was published
+     */
+    bool publishIfChanged(const T &value) {
+        // The writer is the only task modifying slots, no seqlock needed here
+        const Slot &slot = _slots[_latest.load(std::memory_order_relaxed)];
+        if (slot.version != 0 && memcmp(&slot.data, &value, sizeof(T)) == 0) {
+            return false;
+        }
+        publish(value);
+        return true;
+    }
+
+    /**
+     * @brief Copy the latest consistent value
+     *
+     * Retries only if the writer overwrote the slot during the copy,
+     * which requires two publishes within one copy and is rare.
+     *
+     * @param out Destination for the copy
+     * @return uint32_t Version of the copied value (0 = never published)
+     */
+    uint32_t read(T &out) const {
+        for (;;) {
+            const Slot &slot = _slots[_latest.load(std::memory_order_acquire)];
+
+            uint32_t seq = slot.seq.load(std::memory_order_acquire);
+            if (seq & 1) {
+                continue;
+            }
+
+            memcpy(&out, &slot.data, sizeof(T));
+            uint32_t version = slot.version;
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (slot.seq.load(std::memory_order_relaxed) == seq) {
+                return version;
+            }
+        }
+    }
+
+    /**
+     * @brief Process the latest consistent value in place
+     *
+     * Avoids an intermediate copy for large values. The reader function
+     * is called again if the writer overwrote the slot meanwhile, so
+     * it must tolerate being called with torn data (e.g. clamp lengths)
+     * and only trust the result of the last call.
+     *
+     * @param reader Callable taking (const T &)
+     * @return uint32_t Version of the value passed to the last call
+     */
+    template <typename Reader>
+    uint32_t readWith(Reader reader) const {
+        for (;;) {
+            const Slot &slot = _slots[_latest.load(std::memory_order_acquire)];
+
+            uint32_t seq = slot.seq.load(std::memory_order_acquire);
+            if (seq & 1) {
+                continue;
+            }
+
+            reader(slot.data);
+            uint32_t version = slot.version;
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (slot.seq.load(std::memory_order_relaxed) == seq) {
+                return version;
+            }
+        }
+    }
+
+    /**
+     * @brief Version of the latest published value
+     *
+     * Increments on every publish(); useful to detect changes without
+     * copying the data.
+     *
+     * @return uint32_t Current version (0 = never published)
+     */
+    uint32_t version() const {
+        for (;;) {
+            const Slot &slot = _slots[_latest.load(std::memory_order_acquire)];
+
+            uint32_t seq = slot.seq.load(std::memory_order_acquire);
+            uint32_t version = slot.version;
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (!(seq & 1) && slot.seq.load(std::memory_order_relaxed) == seq) {
+                return version;
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> seq; // Odd while the slot is being written
+        uint32_t version;          // Publish counter of the stored value
+        T data;
+    };
+
+    Slot _slots[2];
+    std::atomic<uint8_t> _latest; // Index of the slot readers should use
+};
+
+#endif // SENSOR_SNAPSHOT_H
@@ -0,0 +1,129 @@
+// Generated by scripts/embed_web.py from web/ - do not edit
+
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <Arduino.h>
+
+// Statische Datei der Weboberfläche (gzip-komprimiert im Flash)
+struct WebAsset {
+    const char *path;        // URL
+    const char *contentType;
+    const uint8_t *data;     // gzip-Daten
+    size_t length;
+    const char *etag;
+    bool immutable;          // Über ?v=<etag> versioniert, darf unbegrenzt gecacht werden
+};
+
+// / (356 bytes gzip)
+const uint8_t WEB_ASSET_0[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x6d, 0x52, 0x4d, 0x4b, 0x03, 0x31,
+    0x10, 0xbd, 0xf7, 0x57, 0xc4, 0x9c, 0xdd, 0xa6, 0x5b, 0xad, 0x14, 0xc9, 0xae, 0x88, 0x56, 0x10,
+    0x04, 0x8b, 0xad, 0x07, 0x8f, 0xd9, 0x64, 0x24, 0xd1, 0xdd, 0x6c, 0x48, 0xa6, 0x5b, 0xfa, 0xef,
+    0x4d, 0xf6, 0x43, 0x0a, 0x7a, 0xc9, 0x24, 0x6f, 0xe6, 0xbd, 0x79, 0x33, 0x84, 0x5f, 0x3c, 0xbe,
+    0x3e, 0xec, 0x3f, 0xb6, 0x1b, 0xa2, 0xb1, 0xa9, 0xcb, 0x19, 0x9f, 0x02, 0x08, 0x15, 0x43, 0x03,
+    0x28, 0x88, 0xd4, 0xc2, 0x07, 0xc0, 0x82, 0xbe, 0xef, 0x9f, 0xb2, 0x35, 0x9d, 0x60, 0x2b, 0x1a,
+    0x28, 0x68, 0x67, 0xe0, 0xe8, 0x5a, 0x8f, 0x94, 0xc8, 0xd6, 0x22, 0xd8, 0x58, 0x76, 0x34, 0x0a,
+    0x75, 0xa1, 0xa0, 0x33, 0x12, 0xb2, 0xfe, 0x71, 0x49, 0x8c, 0x35, 0x68, 0x44, 0x9d, 0x05, 0x29,
+    0x6a, 0x28, 0xf2, 0xf9, 0x22, 0xc9, 0xa0, 0xc1, 0x1a, 0xca, 0xbd, 0x06, 0xdf, 0xb4, 0xfa, 0x50,
+    0xad, 0xc9, 0x0e, 0x05, 0x1e, 0x02, 0x67, 0x43, 0x62, 0xc6, 0x6b, 0x63, 0xbf, 0x89, 0x87, 0xba,
+    0xa0, 0x01, 0x4f, 0x35, 0x04, 0x0d, 0x10, 0x1b, 0x69, 0x0f, 0x9f, 0x23, 0x32, 0x97, 0x21, 0xdc,
+    0x75, 0xc5, 0xd5, 0x7a, 0xb5, 0x5c, 0xad, 0x16, 0x90, 0x44, 0xd9, 0x68, 0xbd, 0x6a, 0xd5, 0x29,
+    0x06, 0x65, 0x3a, 0x22, 0x6b, 0x11, 0x42, 0x41, 0x93, 0x41, 0x61, 0x2c, 0xf8, 0x54, 0xa6, 0xf3,
+    0xf3, 0xc6, 0x19, 0xd9, 0x81, 0x0d, 0xad, 0xff, 0x75, 0x10, 0xd3, 0x03, 0xd7, 0xa8, 0xd8, 0xaa,
+    0xcf, 0x05, 0x5a, 0x72, 0x16, 0xa1, 0xa4, 0x7d, 0x40, 0x6c, 0xed, 0xa4, 0x1b, 0xed, 0xf8, 0xe8,
+    0x2d, 0xab, 0xd0, 0xd2, 0xbe, 0x7e, 0x04, 0x68, 0xf9, 0x36, 0x5c, 0x38, 0x1b, 0x08, 0x91, 0xe9,
+    0x26, 0x52, 0x1a, 0x2d, 0x2a, 0xce, 0xee, 0xb7, 0xcf, 0x64, 0x63, 0x95, 0x6b, 0x8d, 0xc5, 0x5b,
+    0xc2, 0xc5, 0x38, 0x1d, 0x13, 0xce, 0xb0, 0x2e, 0x67, 0x43, 0x6b, 0x25, 0x50, 0xd0, 0xf2, 0x2f,
+    0xc6, 0x99, 0x28, 0x79, 0xe5, 0xcb, 0xd9, 0x8b, 0xe9, 0x80, 0x04, 0xf4, 0x20, 0x9a, 0xff, 0x44,
+    0xfa, 0xc4, 0x99, 0x40, 0xff, 0x4e, 0xe4, 0xb8, 0x2e, 0x97, 0x8e, 0x61, 0xac, 0x20, 0xbd, 0x71,
+    0x48, 0x82, 0x97, 0x05, 0x15, 0xce, 0xcd, 0xbf, 0xfa, 0xdd, 0xde, 0x54, 0x4b, 0x95, 0x57, 0xd7,
+    0x69, 0xfa, 0xa1, 0x20, 0x11, 0xc6, 0xed, 0xb2, 0xe1, 0xbb, 0xfc, 0x00, 0x8f, 0xd4, 0xe8, 0x93,
+    0x46, 0x02, 0x00, 0x00,
+};
+
+// /app.js (705 bytes gzip)
+const uint8_t WEB_ASSET_1[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x75, 0x54, 0xdb, 0x6e, 0xdb, 0x30,
+    0x0c, 0x7d, 0xcf, 0x57, 0xb0, 0x7d, 0x91, 0x8c, 0x65, 0x76, 0xba, 0x0b, 0x30, 0xb4, 0x4d, 0x07,
+    0xb4, 0xc8, 0xd6, 0x0e, 0x6d, 0x07, 0xac, 0x79, 0x18, 0x30, 0xec, 0x41, 0xb3, 0xe8, 0x58, 0x98,
+    0x22, 0x79, 0x92, 0x1c, 0xb7, 0x28, 0xf2, 0x4f, 0xfb, 0x86, 0x7d, 0xd9, 0x28, 0x5f, 0x92, 0x74,
+    0x59, 0xdf, 0x14, 0xf3, 0x90, 0x3c, 0x3c, 0x3c, 0x4c, 0x96, 0xc1, 0xbc, 0x44, 0xb7, 0xb4, 0x65,
+    0xfd, 0xe3, 0x1d, 0xf8, 0x20, 0x42, 0xed, 0xa1, 0x12, 0x0b, 0x3c, 0x86, 0x50, 0x62, 0xfb, 0x02,
+    0x15, 0x3c, 0xea, 0x02, 0x94, 0x6f, 0xe3, 0x2a, 0x07, 0x61, 0x24, 0xe4, 0x22, 0x2f, 0x51, 0x8e,
+    0x41, 0xab, 0x15, 0x8e, 0xb2, 0x0c, 0x56, 0x42, 0xd7, 0xe8, 0x21, 0xb7, 0x4b, 0x84, 0xc2, 0xd9,
+    0x25, 0x64, 0xa2, 0x52, 0xd9, 0xea, 0x28, 0xf3, 0xc1, 0xa1, 0x58, 0x02, 0x2f, 0x94, 0xf3, 0x01,
+    0x70, 0x85, 0x26, 0xc0, 0x14, 0x84, 0xd6, 0xe0, 0xd1, 0x78, 0xeb, 0x3c, 0x34, 0x2a, 0x94, 0x60,
+    0xc4, 0x12, 0xfd, 0x38, 0x56, 0xa2, 0xbe, 0x06, 0xac, 0xd1, 0x0f, 0x90, 0x97, 0xc2, 0x2c, 0x50,
+    0xd2, 0x0f, 0xf4, 0x49, 0x0a, 0xe7, 0xce, 0x36, 0x1e, 0xfb, 0x04, 0x5b, 0x07, 0x98, 0xc5, 0x62,
+    0x77, 0xb6, 0x76, 0x39, 0x31, 0xb5, 0x5a, 0xc7, 0xec, 0x4d, 0xdb, 0xb6, 0xb8, 0x14, 0x41, 0x8c,
+    0xa1, 0x29, 0x55, 0x5e, 0x12, 0x6b, 0xdf, 0xc4, 0xec, 0xd7, 0x93, 0x37, 0xf1, 0x8b, 0x46, 0x30,
+    0x36, 0x94, 0xca, 0x2c, 0x86, 0x3e, 0xe9, 0x88, 0x17, 0xb5, 0xc9, 0x83, 0xb2, 0x06, 0x78, 0x02,
+    0x8f, 0x23, 0xa0, 0xa9, 0x1c, 0x4d, 0xe8, 0x23, 0x63, 0x69, 0xf3, 0x7a, 0x49, 0xfd, 0xd2, 0x05,
+    0x86, 0x99, 0xc6, 0xf8, 0x3c, 0x7f, 0xb8, 0x92, 0x9c, 0xf5, 0x63, 0xb0, 0xe4, 0xa4, 0x4f, 0x88,
+    0x34, 0x29, 0xe1, 0x71, 0x7d, 0x32, 0xa2, 0x2f, 0x9b, 0x92, 0xbe, 0xb4, 0x0d, 0xf7, 0x5d, 0xdd,
+    0x0d, 0x90, 0x70, 0x11, 0xfe, 0xcd, 0xa7, 0x4a, 0x7e, 0x3f, 0x69, 0x23, 0xaa, 0x00, 0x7e, 0x40,
+    0x1f, 0x07, 0x24, 0xec, 0xe1, 0x76, 0xd9, 0xe4, 0xa4, 0x6e, 0xc0, 0x9e, 0x10, 0x67, 0x52, 0xad,
+    0x3a, 0x22, 0x7d, 0x5e, 0x9a, 0x6b, 0xe1, 0xfd, 0x2d, 0x89, 0x4b, 0x49, 0x3d, 0x55, 0xb6, 0x1b,
+    0x57, 0xc6, 0xa0, 0xbb, 0x9c, 0xdf, 0x5c, 0x53, 0xfc, 0xf0, 0xd4, 0x57, 0xc2, 0x40, 0x9b, 0x32,
+    0xed, 0xc1, 0x2f, 0xe3, 0x62, 0xd8, 0xd9, 0x69, 0x16, 0x43, 0x67, 0xff, 0x03, 0x04, 0x5c, 0x56,
+    0x1b, 0xc0, 0xe1, 0x50, 0x3b, 0xaa, 0x96, 0x8a, 0xaa, 0x42, 0x23, 0x2f, 0x48, 0x6c, 0xc9, 0xe3,
+    0x44, 0x5d, 0x70, 0xbd, 0x19, 0xd3, 0xa7, 0xb1, 0x3a, 0x1c, 0x4c, 0xa7, 0x50, 0x1b, 0x89, 0x85,
+    0x32, 0x28, 0x93, 0x96, 0x56, 0xeb, 0x96, 0x36, 0x31, 0x0d, 0x78, 0x1f, 0x2e, 0xac, 0x09, 0x9d,
+    0x71, 0xba, 0x94, 0xae, 0x50, 0x04, 0x12, 0x95, 0x67, 0x70, 0xad, 0x23, 0xdb, 0xda, 0xa6, 0x26,
+    0x6f, 0x74, 0xb4, 0xde, 0x0f, 0x81, 0x34, 0xd8, 0x0f, 0xea, 0x1e, 0x25, 0x3f, 0x4a, 0xe0, 0x05,
+    0x30, 0xf8, 0xf3, 0xfb, 0x82, 0xd1, 0x83, 0x28, 0xf5, 0x47, 0x30, 0x8d, 0x7a, 0x05, 0xa1, 0x91,
+    0x51, 0x12, 0xa3, 0x40, 0x7c, 0x27, 0x0c, 0x8e, 0x81, 0xb1, 0xa4, 0xaf, 0x46, 0xef, 0x99, 0x73,
+    0xbd, 0xa2, 0xeb, 0x27, 0xdb, 0xae, 0x2b, 0xf2, 0x1e, 0xf2, 0x68, 0xc0, 0x61, 0x91, 0xf1, 0x9d,
+    0xf6, 0x6e, 0x49, 0x0b, 0xeb, 0x66, 0x74, 0x42, 0x3c, 0xba, 0x22, 0xd9, 0x4f, 0xd7, 0x56, 0x48,
+    0xbe, 0xeb, 0x95, 0xfb, 0xd2, 0xd1, 0x54, 0x06, 0x1b, 0xf8, 0x7a, 0x73, 0x7d, 0x19, 0x42, 0xf5,
+    0x05, 0x7f, 0xd1, 0xc1, 0x05, 0xde, 0x8b, 0x4a, 0xf1, 0xd4, 0x92, 0xda, 0x9c, 0x7d, 0x9c, 0xcd,
+    0xd9, 0x18, 0xd8, 0xfe, 0x21, 0xb0, 0x5d, 0xa8, 0x89, 0x1d, 0xa8, 0xe2, 0xbf, 0x8e, 0x1f, 0x56,
+    0x13, 0x41, 0x5b, 0x25, 0x5e, 0x4d, 0x26, 0xc9, 0x30, 0xd2, 0xa7, 0xbb, 0xcf, 0xb7, 0x69, 0x25,
+    0x9c, 0xc7, 0x16, 0xe4, 0xd0, 0x57, 0xd6, 0x78, 0x9c, 0x93, 0xfc, 0xc9, 0xb0, 0xe1, 0x6d, 0x23,
+    0x6a, 0x2f, 0xf9, 0x76, 0xc0, 0x67, 0xaf, 0xc8, 0x61, 0x41, 0x95, 0x4a, 0x96, 0x10, 0xb5, 0x5c,
+    0xab, 0xfc, 0x27, 0x71, 0x8b, 0x14, 0xdb, 0x1b, 0x8a, 0x84, 0x1a, 0x65, 0x24, 0xed, 0x7b, 0xe7,
+    0xe6, 0x07, 0xc2, 0x51, 0x94, 0x9d, 0xcf, 0x9c, 0x3d, 0xfd, 0xeb, 0xa1, 0x92, 0x42, 0xca, 0x16,
+    0x70, 0x4d, 0xa6, 0x44, 0xf2, 0x7b, 0x6c, 0x27, 0x24, 0x9d, 0xbe, 0x27, 0xa5, 0xb6, 0x0a, 0xe0,
+    0x56, 0x82, 0xfd, 0x59, 0x31, 0x6d, 0x77, 0x39, 0x4c, 0xd8, 0x8d, 0x04, 0xa8, 0x3d, 0xf6, 0x49,
+    0xdd, 0xca, 0xba, 0xb0, 0xc7, 0x70, 0x45, 0x4e, 0x74, 0x64, 0x35, 0x1e, 0xbf, 0x8f, 0xe1, 0xed,
+    0x84, 0x24, 0xec, 0x64, 0x58, 0x27, 0x11, 0xf6, 0x17, 0x06, 0x2b, 0xa4, 0x22, 0x7a, 0x05, 0x00,
+    0x00,
+};
+
+// /style.css (356 bytes gzip)
+const uint8_t WEB_ASSET_2[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x6d, 0x92, 0xc1, 0x6e, 0xc3, 0x20,
+    0x0c, 0x86, 0xef, 0x7b, 0x0a, 0x4b, 0xbd, 0x6c, 0x52, 0xa9, 0x48, 0xaa, 0x46, 0x1b, 0x39, 0xed,
+    0x51, 0x48, 0x30, 0x09, 0x6b, 0x02, 0x08, 0xc8, 0x92, 0x6e, 0xda, 0xbb, 0x0f, 0xd2, 0xa6, 0x4a,
+    0xba, 0xc9, 0xe2, 0x62, 0xcc, 0xef, 0xcf, 0xbf, 0xa9, 0x8c, 0xb8, 0xc0, 0x37, 0x48, 0xa3, 0x03,
+    0x91, 0xbc, 0x57, 0xdd, 0x85, 0xc1, 0xbb, 0x53, 0xbc, 0xdb, 0x83, 0xe7, 0xda, 0x13, 0x8f, 0x4e,
+    0xc9, 0x12, 0x7a, 0xee, 0x1a, 0xa5, 0x19, 0xe4, 0xd4, 0x4e, 0x25, 0x54, 0xbc, 0x3e, 0x37, 0xce,
+    0x0c, 0x5a, 0x90, 0xda, 0x74, 0xc6, 0x31, 0xd8, 0x49, 0x9a, 0xa2, 0x84, 0x9f, 0xa7, 0x36, 0x8b,
+    0x7a, 0x4b, 0xfa, 0x78, 0x3c, 0xa6, 0xdc, 0xa1, 0x8e, 0xfa, 0x5c, 0x69, 0x74, 0xf1, 0xae, 0xe7,
+    0x13, 0x19, 0x95, 0x08, 0x2d, 0x83, 0x57, 0x3a, 0xeb, 0x2d, 0xea, 0x14, 0xf8, 0x10, 0xcc, 0x5a,
+    0x9f, 0xc1, 0xd8, 0xaa, 0x80, 0x25, 0x58, 0x2e, 0x84, 0xd2, 0xcd, 0x9d, 0xc0, 0x38, 0x81, 0x8e,
+    0x38, 0x2e, 0xd4, 0xe0, 0x19, 0x64, 0xb7, 0xe4, 0x44, 0x7c, 0xcb, 0x85, 0x19, 0x93, 0x54, 0x6e,
+    0x27, 0x38, 0xc5, 0xe3, 0x9a, 0x8a, 0x3f, 0xd3, 0xfd, 0x1c, 0x87, 0xec, 0x65, 0xc6, 0xf1, 0xa8,
+    0xbd, 0x49, 0x2c, 0x42, 0x79, 0xdb, 0xf1, 0x38, 0xb3, 0xec, 0x30, 0x2a, 0x7c, 0x0c, 0x3e, 0x28,
+    0x79, 0x21, 0x09, 0x17, 0x75, 0x60, 0xe0, 0x2d, 0xaf, 0x91, 0x54, 0x18, 0x46, 0x44, 0xbd, 0xa2,
+    0xc8, 0x36, 0xdc, 0xa9, 0x0d, 0xdd, 0x62, 0xef, 0xe4, 0x5b, 0x8a, 0x3f, 0xa4, 0xa7, 0xf4, 0xee,
+    0x4e, 0x40, 0x34, 0xef, 0x71, 0xb1, 0x7f, 0x44, 0xd5, 0xb4, 0xb1, 0x67, 0x65, 0x3a, 0xb1, 0xae,
+    0x09, 0xd8, 0xdb, 0x95, 0xa5, 0x94, 0x16, 0x45, 0x5d, 0xcf, 0x05, 0x0e, 0xa5, 0x43, 0xdf, 0x92,
+    0x2a, 0xe8, 0x58, 0xb0, 0x69, 0xbf, 0x54, 0xdd, 0x5e, 0xdd, 0x5c, 0xbc, 0xc2, 0x30, 0xd0, 0x46,
+    0xe3, 0xc3, 0x34, 0xff, 0x1b, 0x3b, 0xe3, 0xd6, 0x83, 0xf3, 0x49, 0xc4, 0x1a, 0x15, 0x6d, 0x71,
+    0xcb, 0xdc, 0x24, 0x18, 0xbb, 0xec, 0x63, 0x0b, 0xc3, 0x5a, 0xf3, 0x39, 0xaf, 0xfa, 0x01, 0xe9,
+    0x94, 0xf3, 0xeb, 0x77, 0xe8, 0x94, 0x3e, 0xfb, 0xf9, 0x2b, 0x3c, 0x0a, 0x2d, 0x53, 0x16, 0x45,
+    0x51, 0x5e, 0x6d, 0xf1, 0xea, 0x0b, 0x23, 0x62, 0x7e, 0x6d, 0xf3, 0x0b, 0x8d, 0x03, 0x28, 0xd9,
+    0xb0, 0x02, 0x00, 0x00,
+};
+
+const WebAsset WEB_ASSETS[] = {
+    {"/", "text/html", WEB_ASSET_0, 356, "\"26502a82\"", false},
+    {"/app.js", "application/javascript", WEB_ASSET_1, 705, "\"36b2d1b4\"", true},
+    {"/style.css", "text/css", WEB_ASSET_2, 356, "\"3852550e\"", true},
+};
+
+constexpr size_t WEB_ASSET_COUNT = sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]);
+
+#endif // WEB_ASSETS_H
@@ -30,16 +30,39 @@
 #include <AsyncTCP.h>
 #include <ArduinoJson.h>
 #include <Preferences.h>
+#include <LittleFS.h>
 #include <ModbusMaster.h>
 #include <LiquidCrystal_I2C.h>
+#include <esp_timer.h>
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <esp_mac.h>
+#include <esp_random.h>
+#include <driver/gpio.h>
 #include "Joystick.h"
+#include "SensorSnapshot.h"
+#include "LcdFrameBuffer.h"
+#include "BodyAccumulator.h"
+#include "SensorCore.h"
+#include "SensorRender.h"
+#include "SensorFilter.h"
+#include "AlarmEngine.h"
+#include "ModbusMasterTransport.h"
+#include "LinkHealth.h"
+#include "ModbusAcquisition.h"
+#include "SensorHistory.h"
+#include "FlashLog.h"
+#include "MqttPublisher.h"
+#include "FirmwareUpdate.h"
+#include "Metrics.h"
+#include "WebAssets.h"
+#include <memory>
 
 // ============================================================================
 // CONFIGURATION SECTION
 // ============================================================================
 
-// Number of sensors to read (configurable, default: 8)
-#define NUM_SENSORS 8
+#define FIRMWARE_VERSION "1.0"
 
 // Status LED Configuration
 #define STATUS_LED 2 // GPIO pin for Modbus activity LED indicator
@@ -49,18 +72,176 @@
 const char *WIFI_SSID = "ADD YOUR SSID HERE";             // WiFi network name
 const char *WIFI_PASSWORD = "ADD YOUR WIFI PW HERE"; // WiFi password
 const char *HOSTNAME = "thermohub8";           // mDNS hostname (access via thermohub8.local)
+#define WIFI_RECONNECT_INTERVAL 30000 // Retry interval in milliseconds while disconnected
+#define NTP_SERVER "pool.ntp.org"     // Wall-clock time source (UTC)
+#define CLOCK_MIN_VALID_TIME 1704067200 // Clock counts as set after 2024-01-01
+
+// MQTT Configuration
+// Empty broker URI = MQTT disabled. The /api/v1/sensordata JSON is
+// published (retained) whenever it changes, Home Assistant creates the
+// sensors through MQTT discovery. Publishing runs in its own task and
+// never waits for the broker: while the outbox is full, samples are
+// skipped and the newest one is sent once there is room again.
+const char *MQTT_BROKER_URI = "";  // e.g. "mqtt://192.168.1.10:1883"
+const char *MQTT_USERNAME = "";    // Empty = anonymous
+const char *MQTT_PASSWORD = "";
+#define MQTT_BASE_TOPIC "thermohub8"          // Topics: thermohub8/<device>/state and .../status
+#define MQTT_DISCOVERY_PREFIX "homeassistant" // Home Assistant discovery prefix ("" = no discovery)
+#define MQTT_STATE_QOS 0                      // QoS of the state topic (discovery always uses 1)
+#define MQTT_OUTBOX_LIMIT 8192                // Bytes waiting for the broker before messages are dropped
+#define MQTT_RETRY_INTERVAL 1000              // Retry after a dropped message or reconnect (ms)
+#define MQTT_TASK_CORE 1                      // CPU core of the publisher task
+#define MQTT_TASK_PRIORITY 1                  // Below the acquisition task
+#define MQTT_TASK_STACK_SIZE 6144             // Includes the discovery JSON document
+#define MQTT_DISCOVERY_SIZE 768               // One discovery config payload
 
 // RS485/Modbus Pin Configuration
 // MAX485 module connections to ESP32
 #define RS485_TX_PIN 16   // UART TX pin for Modbus communication
 #define RS485_RX_PIN 17   // UART RX pin for Modbus communication
-#define RS485_DE_RE_PIN 4 // Driver Enable / Receiver Enable control pin
+#define RS485_DE_RE_PIN 4 // Driver Enable / Receiver Enable control pin (UART RTS in hardware mode)
 
 // Modbus Protocol Configuration
 #define MODBUS_SLAVE_ID 1           // Modbus slave device ID
 #define MODBUS_START_REGISTER 0x30  // Starting register address (48 decimal)
-#define MODBUS_BAUDRATE 9600        // Communication speed (9600 baud)
+#define MODBUS_BAUDRATE 9600        // Default communication speed, changeable via /api/v1/sensors
+#define MODBUS_BAUD_AUTO_PROBE false // Search the speed at startup if no module answers
+#define MODBUS_HW_DIRECTION true    // UART drives DE/RE (RS485 half-duplex mode) instead of software
+#define MODBUS_RX_TIMEOUT 4         // Idle time in characters that ends a response frame (hardware mode)
 #define MODBUS_UPDATE_INTERVAL 1000 // Sensor read interval in milliseconds
+#define MODBUS_BLOCK_READ true      // Read all sensors in one transaction (falls back to single reads)
+#define MODBUS_MAX_BLOCK_REGISTERS 64 // ModbusMaster response buffer size (ku8MaxBufferSize)
+
+// Supported bus speeds (all modules on the segment use the same one)
+constexpr uint32_t MODBUS_BAUD_RATES[] = {9600, 19200, 38400, 57600, 115200};
+#define NUM_MODBUS_BAUD_RATES (sizeof(MODBUS_BAUD_RATES) / sizeof(MODBUS_BAUD_RATES[0]))
+
+// Modbus Fault Handling
+// A module that stops answering costs a full response timeout (2 s in
+// ModbusMaster) per request. Failed polls are therefore spaced out
+// (exponential backoff from the poll interval up to MODBUS_BACKOFF_MAX);
+// after MODBUS_TRIP_FAILURES failed polls in a row the module is only
+// probed every MODBUS_PROBE_INTERVAL until it answers again. With single
+// register reads the same applies per channel. Garbled responses (CRC,
+// wrong slave/function) are retried right away, timeouts never.
+#define MODBUS_RETRIES 1              // Immediate retries of a garbled response
+#define MODBUS_BACKOFF_MAX 30000      // Longest wait between failed polls in ms
+#define MODBUS_TRIP_FAILURES 5        // Failed polls in a row until probing only
+#define MODBUS_PROBE_INTERVAL 60000   // Probe interval of a dead module/channel in ms
+
+// Modbus Bus Configuration
+// One entry per slave on the RS485 segment
+struct ModbusDevice
+{
+    uint8_t slaveId;                 // Modbus slave address
+    ModbusRegisterType registerType; // Register table holding the values
+    uint32_t pollInterval;           // Read interval in milliseconds
+    uint8_t priority;                // Higher value is read first when several devices are due
+};
+
+constexpr ModbusDevice MODBUS_DEVICES[] = {
+    // slave ID,     registers,         interval,               priority
+    {MODBUS_SLAVE_ID, HOLDING_REGISTERS, MODBUS_UPDATE_INTERVAL, 1},
+    // {2,           HOLDING_REGISTERS, 200,                    2}, // Fast process loop
+    // {3,           INPUT_REGISTERS,   30000,                  0}, // Slow ambient sensors
+};
+#define NUM_MODBUS_DEVICES (sizeof(MODBUS_DEVICES) / sizeof(MODBUS_DEVICES[0]))
+
+// Sensor Channel Map
+// One entry per sensor, in sensor number order. The channels of one
+// device must be listed consecutively; each device is read with one
+// block covering the registers of all its channels. Buffers, the poll
+// loop, JSON payloads and the LCD menu are sized from this table.
+// Formats (FORMAT_FLOAT_ABCD/CDAB/BADC/DCBA, FORMAT_INT16/UINT16/INT32)
+// are listed in SensorCore.h; scale converts the decoded value to °C.
+constexpr SensorChannel SENSOR_CHANNELS[] = {
+    // device, register,                  format,            scale, label
+    {0, MODBUS_START_REGISTER + 0x00, FORMAT_FLOAT_ABCD, 1.0f, "Sensor 1"},
+    {0, MODBUS_START_REGISTER + 0x02, FORMAT_FLOAT_ABCD, 1.0f, "Sensor 2"},
+    {0, MODBUS_START_REGISTER + 0x04, FORMAT_FLOAT_ABCD, 1.0f, "Sensor 3"},
+    {0, MODBUS_START_REGISTER + 0x06, FORMAT_FLOAT_ABCD, 1.0f, "Sensor 4"},
+    {0, MODBUS_START_REGISTER + 0x08, FORMAT_FLOAT_ABCD, 1.0f, "Sensor 5"},
+    {0, MODBUS_START_REGISTER + 0x0A, FORMAT_FLOAT_ABCD, 1.0f, "Sensor 6"},
+    {0, MODBUS_START_REGISTER + 0x0C, FORMAT_FLOAT_ABCD, 1.0f, "Sensor 7"},
+    {0, MODBUS_START_REGISTER + 0x0E, FORMAT_FLOAT_ABCD, 1.0f, "Sensor 8"},
+    // {1, 0x30,                      FORMAT_FLOAT_CDAB, 1.0f,  "Process"},
+    // {2, 0x00,                      FORMAT_INT16,      0.1f,  "Ambient"},
+};
+
+// Number of sensors, taken from the channel map
+#define NUM_SENSORS ((int)(sizeof(SENSOR_CHANNELS) / sizeof(SENSOR_CHANNELS[0])))
+
+// Adaptive Polling Configuration
+// A device whose channels all stay within the deadband doubles its poll
+// interval after every read (up to ADAPTIVE_MAX_INTERVAL) and returns to
+// its configured interval as soon as one channel moves further.
+#define ADAPTIVE_POLLING true        // false = always use the configured interval
+#define ADAPTIVE_DEADBAND 20         // Change in 0.01 °C that counts as significant (0.2 °C)
+#define ADAPTIVE_MAX_INTERVAL 30000  // Longest poll interval in milliseconds
+#define REPORT_DEADBAND 10           // Change in 0.01 °C pushed to stream clients (0.1 °C)
+
+// Filter and Statistics Configuration
+// Every new reading passes a median (spike rejection) and an EMA before
+// it is published; both are set per sensor via /api/v1/sensors. The
+// published values are also aggregated over STATISTICS_WINDOWS for
+// /api/v1/statistics.
+#define FILTER_DEFAULT_MEDIAN 1      // Median window in samples (1 = off, odd up to 7)
+#define FILTER_DEFAULT_SMOOTHING 0   // EMA alpha = 1/2^n (0 = off, up to 8)
+constexpr uint32_t STATISTICS_WINDOWS[] = {60000, 300000, 3600000}; // Window lengths in ms
+#define NUM_STATISTICS_WINDOWS ((int)(sizeof(STATISTICS_WINDOWS) / sizeof(STATISTICS_WINDOWS[0])))
+
+// Alarm Configuration
+// Rules are checked right after every new (filtered) reading on the
+// acquisition task, independent of WiFi. An active rule drives its
+// output GPIO, lights the status LED, shows a banner on the LCD and is
+// pushed to /api/v1/stream and MQTT. It clears once the value moved
+// back by the hysteresis. Rates are in °C per minute.
+constexpr AlarmRule ALARM_RULES[] = {
+    // sensor, type,       threshold, hysteresis, output GPIO, label (max 12 chars)
+    {0, ALARM_HIGH, 95.0f, 2.0f, -1, "Overheat"},
+    // {1, ALARM_LOW,  3.0f,  1.0f, 4,  "Frost"},     // Relay on GPIO 4 below 3 °C, off above 4 °C
+    // {0, ALARM_RISE, 5.0f,  1.0f, -1, "Fast rise"}, // Rising by 5 °C/min or more
+};
+#define NUM_ALARM_RULES ((int)(sizeof(ALARM_RULES) / sizeof(ALARM_RULES[0])))
+#define ALARM_RATE_WINDOW 30000   // Reference age for rates in ms (reaction within 1-2 windows)
+#define ALARM_OUTPUT_ACTIVE HIGH  // Level of an output GPIO while its alarm is active
+#define ALARM_LABEL_LENGTH 12     // Longest label (LCD banner: "!" + label + "+n")
+
+// Acquisition Task Configuration
+// Modbus polling runs in its own FreeRTOS task so a slow or missing slave
+// never blocks the LCD and joystick handling in loop() (core 1)
+#define ACQUISITION_TASK_CORE 0        // CPU core the acquisition task is pinned to
+#define ACQUISITION_TASK_PRIORITY 2    // FreeRTOS priority (above idle, below WiFi)
+#define ACQUISITION_TASK_STACK_SIZE 6144 // Stack size in bytes (includes JSON rendering)
+
+// REST API Configuration
+#define JSON_SENSOR_SIZE 128  // Upper bound of one sensor entry in a JSON payload
+#define JSON_CACHE_SIZE (32 + NUM_SENSORS * JSON_SENSOR_SIZE)   // Pre-serialized /api/v1/sensordata payload
+#define STREAM_EVENT_SIZE (32 + NUM_SENSORS * JSON_SENSOR_SIZE) // One /api/v1/stream event
+#define BINARY_CACHE_SIZE SENSOR_BINARY_SIZE(NUM_SENSORS)        // Pre-rendered /api/v1/sensordata.bin payload
+#define ALARM_JSON_SIZE (64 + NUM_ALARM_RULES * 160) // Alarm state document (API, stream, MQTT)
+#define STATISTICS_JSON_SIZE (256 + NUM_SENSORS * (128 + NUM_STATISTICS_WINDOWS * 96)) // /api/v1/statistics document
+
+// History Configuration
+// Readings are kept in RAM (delta-encoded) for /api/v1/history
+#define HISTORY_INTERVAL 10                // Seconds between history rows
+#define HISTORY_MEMORY_SIZE (48 * 1024)    // Internal RAM used for the history
+#define HISTORY_PSRAM_SIZE (1024 * 1024)   // Used instead if the board has PSRAM
+
+// Flash Log Configuration
+// Readings are appended to LittleFS for /api/v1/log and survive reboots.
+// Records are written in batches by a low-priority task; one batch is one
+// flash write, so FLASH_LOG_BATCH_SIZE bounds the write stall and
+// FLASH_LOG_FLUSH_INTERVAL bounds the writes per day (and the data lost
+// on a power failure).
+#define FLASH_LOG_INTERVAL 60                   // Seconds between records
+#define FLASH_LOG_DIRECTORY "/log"              // Segment files on LittleFS
+#define FLASH_LOG_SEGMENT_SIZE (64 * 1024)      // Maximum size of one segment file
+#define FLASH_LOG_SEGMENTS 16                   // Segments kept (oldest is deleted)
+#define FLASH_LOG_BATCH_SIZE 512                // Bytes per flash write (25 records with 8 channels)
+#define FLASH_LOG_FLUSH_INTERVAL (30 * 60000UL) // Longest time a record waits in RAM (ms)
+#define FLASH_LOG_TASK_CORE 1                   // CPU core of the writer task
+#define FLASH_LOG_TASK_PRIORITY 1               // Below the acquisition task
 
 // I2C LCD Display Pin Configuration
 // Standard ESP32 I2C pins for LCD communication
@@ -69,6 +250,7 @@ const char *HOSTNAME = "thermohub8";           // mDNS hostname (access via ther
 #define LCD_I2C_ADDR 0x27 // I2C address of LCD (default for PCF8574)
 #define LCD_COLS 16       // Number of columns on LCD
 #define LCD_ROWS 4        // Number of rows on LCD
+#define LCD_LOWER_ROW_OFFSET -4 // Column correction for rows 3-4 (16x4 module, 20x4 addressing)
 
 // Joystick Pin Configuration
 // Analog joystick connected to ADC pins
@@ -83,9 +265,51 @@ const char *HOSTNAME = "thermohub8";           // mDNS hostname (access via ther
 #define JOY_CENTER_VAL 2000 // Center position value (neutral)
 #define JOY_DEADZONE 500    // Deadzone radius to prevent drift
 
+// Joystick Event Mode (button interrupt, timer-sampled axes)
+// Lets loop() sleep until something happens instead of polling at 100 Hz
+#define JOY_EVENT_MODE true       // false = poll in every loop() pass
+#define JOY_SAMPLE_INTERVAL 50    // Axis sampling interval in milliseconds
+#define JOY_HYSTERESIS 150        // ADC counts below the deadzone to leave a direction
+#define LOOP_IDLE_TIMEOUT 1000    // Maximum loop() sleep in event mode (ms)
+
+// Power Management Configuration
+// POWER_MODE_PERFORMANCE: full clock, WiFi always awake (lowest latency)
+// POWER_MODE_BALANCED:    frequency scaling + WiFi modem sleep
+// POWER_MODE_LOW_POWER:   additionally automatic light sleep while idle
+//                         (needs a core built with tickless idle, falls back to BALANCED)
+#define POWER_MODE_PERFORMANCE 0
+#define POWER_MODE_BALANCED 1
+#define POWER_MODE_LOW_POWER 2
+#define POWER_MODE POWER_MODE_PERFORMANCE
+#define POWER_MAX_CPU_FREQ 240         // MHz while busy
+#define POWER_MIN_CPU_FREQ 80          // MHz while idle (min. 80 for WiFi and UART)
+#define LCD_BACKLIGHT_TIMEOUT 0        // Backlight off after ms without joystick input (0 = always on)
+
 // Sensor Display Configuration
 #define MAX_SENSOR_NAME_LENGTH 16 // Maximum characters for sensor name in storage
 #define DISPLAY_NAME_LENGTH 8     // Maximum characters displayed on LCD (to fit temperature)
+#define SENSOR_STALE_CYCLES 3     // Failed poll intervals a last good value is reported as stale
+
+// Configuration Storage
+#define CONFIG_COMMIT_DELAY 2000     // Flash write after the last change settles (ms)
+#define CONFIG_MAX_OFFSET 1000       // Largest calibration offset in 0.01 °C (±10 °C)
+#define CONFIG_MIN_INTERVAL 100      // Shortest configurable poll interval in ms
+#define CONFIG_MAX_INTERVAL 3600000  // Longest configurable poll interval in ms
+#define CONFIG_JSON_SIZE 2048        // JSON document for /api/v1/sensors
+#define CONFIG_BODY_MAX 1536         // Largest accepted PUT /api/v1/sensors body in bytes
+#define SENSOR_BODY_MAX 256          // Largest accepted POST /api/v1/sensor body in bytes
+
+// OTA Firmware Update (POST /api/v1/ota)
+// A new image has to prove itself after the restart: it is confirmed once
+// it ran OTA_HEALTH_MIN_UPTIME with WiFi connected and (optionally) a
+// successful Modbus read; otherwise, or on a crash before that, the
+// bootloader returns to the previous image.
+#define OTA_TOKEN ""                   // Bearer token required for uploads ("" = updates disabled)
+#define OTA_IDLE_TIMEOUT 15000         // A stalled upload may be replaced after ms
+#define OTA_REBOOT_DELAY 1000          // Restart after the response went out (ms)
+#define OTA_HEALTH_MIN_UPTIME 30000    // Uptime before a new image is confirmed (ms)
+#define OTA_HEALTH_TIMEOUT 300000      // Roll back if still not healthy after ms
+#define OTA_HEALTH_REQUIRE_MODBUS true // false = WiFi alone makes the image healthy
 
 // ============================================================================
 // GLOBAL OBJECTS
@@ -93,33 +317,419 @@ const char *HOSTNAME = "thermohub8";           // mDNS hostname (access via ther
 
 // Modbus master instance for RTU communication
 ModbusMaster modbus;
+ModbusMasterTransport modbusTransport(modbus, Serial2);
+
+// Backoff and circuit breaker limits (see LinkHealth.h)
+constexpr LinkPolicy MODBUS_LINK_POLICY = {MODBUS_BACKOFF_MAX, MODBUS_TRIP_FAILURES, MODBUS_PROBE_INTERVAL};
+
+// Per-device view of the channel map, derived at compile time
+struct ModbusDeviceLayout
+{
+    uint8_t firstChannel;   // Index of the device's first sensor
+    uint8_t channels;       // Number of sensors on the device
+    uint16_t firstRegister; // First register of the block read
+    uint16_t registerCount; // Registers covered by the block read
+};
+
+struct ModbusBusLayout
+{
+    ModbusDeviceLayout devices[NUM_MODBUS_DEVICES];
+    bool valid; // Channel map is consistent (see static_asserts below)
+};
+
+constexpr ModbusBusLayout makeModbusBusLayout()
+{
+    ModbusBusLayout layout = {};
+    layout.valid = true;
+
+    for (int d = 0; d < (int)NUM_MODBUS_DEVICES; d++)
+    {
+        ModbusDeviceLayout &device = layout.devices[d];
+        int lastChannel = -1;
+        uint16_t endRegister = 0;
+
+        for (int c = 0; c < NUM_SENSORS; c++)
+        {
+            const SensorChannel &channel = SENSOR_CHANNELS[c];
+            if (channel.device != d)
+            {
+                continue;
+            }
+            if (device.channels == 0)
+            {
+                device.firstChannel = c;
+                device.firstRegister = channel.registerAddress;
+            }
+            else if (c != lastChannel + 1)
+            {
+                layout.valid = false; // Channels of the device not consecutive
+            }
+
+            device.firstRegister = channel.registerAddress < device.firstRegister ? channel.registerAddress : device.firstRegister;
+            uint16_t end = channel.registerAddress + channelRegisterCount(channel.format);
+            endRegister = end > endRegister ? end : endRegister;
+            device.channels++;
+            lastChannel = c;
+        }
+
+        if (device.channels == 0)
+        {
+            layout.valid = false; // Device without channels
+        }
+        device.registerCount = endRegister - device.firstRegister;
+    }
+
+    for (const SensorChannel &channel : SENSOR_CHANNELS)
+    {
+        if (channel.device >= NUM_MODBUS_DEVICES || channel.format >= FORMAT_COUNT)
+        {
+            layout.valid = false; // Unknown device or format
+        }
+    }
+    return layout;
+}
+
+constexpr ModbusBusLayout MODBUS_LAYOUT = makeModbusBusLayout();
+
+constexpr int modbusMaxBlockRegisters()
+{
+    int registers = 0;
+    for (const ModbusDeviceLayout &device : MODBUS_LAYOUT.devices)
+    {
+        registers = device.registerCount > registers ? device.registerCount : registers;
+    }
+    return registers;
+}
+
+constexpr bool sensorLabelsFit()
+{
+    for (const SensorChannel &channel : SENSOR_CHANNELS)
+    {
+        int length = 0;
+        while (channel.label[length] != '\0')
+        {
+            length++;
+        }
+        if (length > MAX_SENSOR_NAME_LENGTH)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(MODBUS_LAYOUT.valid,
+              "SENSOR_CHANNELS: every device needs consecutive channels, every channel a known device and format");
+static_assert(modbusMaxBlockRegisters() <= MODBUS_MAX_BLOCK_REGISTERS &&
+                  MODBUS_MAX_BLOCK_REGISTERS <= ACQUISITION_MAX_REGISTERS,
+              "Block read exceeds the ModbusMaster response buffer");
+static_assert(sensorLabelsFit(), "SENSOR_CHANNELS: label longer than MAX_SENSOR_NAME_LENGTH");
+
+// Alarm rules in fixed point, compiled at build time (see AlarmEngine.h)
+struct AlarmTable
+{
+    CompiledAlarm alarms[NUM_ALARM_RULES];
+    bool valid; // Rule table is consistent (see static_assert below)
+};
+
+constexpr AlarmTable makeAlarmTable()
+{
+    AlarmTable table = {};
+    table.valid = NUM_ALARM_RULES <= ALARM_MAX_RULES;
+
+    for (int i = 0; i < NUM_ALARM_RULES && i < ALARM_MAX_RULES; i++)
+    {
+        const AlarmRule &rule = ALARM_RULES[i];
+        int length = 0;
+        while (rule.label[length] != '\0')
+        {
+            length++;
+        }
+        if (rule.sensor >= NUM_SENSORS || rule.type >= ALARM_TYPE_COUNT || rule.hysteresis < 0 ||
+            rule.threshold * 100 > INT16_MAX || rule.threshold * 100 < INT16_MIN || length > ALARM_LABEL_LENGTH)
+        {
+            table.valid = false;
+        }
+        table.alarms[i] = compileAlarmRule(rule);
+    }
+    return table;
+}
+
+constexpr AlarmTable ALARM_TABLE = makeAlarmTable();
+
+static_assert(ALARM_TABLE.valid,
+              "ALARM_RULES: at most 32 rules, known sensor and type, hysteresis >= 0, label up to ALARM_LABEL_LENGTH");
 
 // LCD display object (16x4 with I2C interface)
 LiquidCrystal_I2C lcd(LCD_I2C_ADDR, LCD_COLS, LCD_ROWS);
 
+// Shadow framebuffer: only changed characters are sent to the LCD
+LcdFrameBuffer lcdFrame(lcd, LCD_COLS, LCD_ROWS, LCD_LOWER_ROW_OFFSET);
+
 // Joystick controller instance
 Joystick joystick(JOY_X_PIN, JOY_Y_PIN, JOY_SW_PIN);
 
 // Async web server on port 80
 AsyncWebServer server(80);
 
+// Server-Sent Events stream for live readings
+AsyncEventSource events("/api/v1/stream");
+
+// In-RAM history of readings (written by loop(), read by web handlers)
+SensorHistory history;
+
+// Persistent log of readings (fed by loop(), written by its own task, read by web handlers)
+FlashLog flashLog;
+
+// MQTT output (fed by the MQTT task, sent by the ESP-IDF client task)
+MqttPublisher mqtt;
+
 // Non-volatile storage for sensor names
 Preferences preferences;
 
+// Runtime metrics, exposed at /metrics (Prometheus) and /api/v1/metrics
+// Every histogram has exactly one writing task (noted per group)
+struct FirmwareMetrics
+{
+    // Acquisition task
+    LatencyHistogram modbusTransaction;      // One request/response on the bus
+    std::atomic<uint32_t> modbusSuccess;     // Completed transactions
+    std::atomic<uint32_t> modbusTimeouts;    // No response within the ModbusMaster timeout
+    std::atomic<uint32_t> modbusCrcErrors;   // Response with invalid CRC
+    std::atomic<uint32_t> modbusExceptions;  // Exception response from the slave
+    std::atomic<uint32_t> modbusOtherErrors; // Wrong slave ID / function in the response
+    std::atomic<uint32_t> modbusRetries;     // Immediate retries after a garbled response
+
+    // loop()
+    LatencyHistogram loopIteration;  // One pass of loop() without the idle delay
+    LatencyHistogram displayUpdate;  // updateDisplay() including the I2C flush
+    LatencyHistogram joystickUpdate; // joystick.update()
+
+    // AsyncTCP task (handler setup and synchronous part of the response)
+    LatencyHistogram httpStatus;
+    LatencyHistogram httpSensorData;
+    LatencyHistogram httpHistory;
+    LatencyHistogram httpLog;
+    LatencyHistogram httpSensor;
+    LatencyHistogram httpMetrics;
+    std::atomic<uint32_t> httpNotFound;
+};
+FirmwareMetrics metrics;
+
 // ============================================================================
 // GLOBAL VARIABLES
 // ============================================================================
 
-// Sensor data arrays
-float sensorTemperatures[NUM_SENSORS]; // Current temperature readings in °C
-String sensorNames[NUM_SENSORS];       // User-defined sensor names
+// Sample set published by the acquisition task
+struct SensorSample
+{
+    SensorReading readings[NUM_SENSORS];
+    unsigned long timestamp; // millis() at the end of the cycle
+};
+
+// User-defined sensor names
+struct SensorNameTable
+{
+    char names[NUM_SENSORS][MAX_SENSOR_NAME_LENGTH + 1];
+};
+
+// User-defined acquisition settings
+struct AcquisitionSettings
+{
+    int16_t offsets[NUM_SENSORS];              // Calibration offset per channel in 0.01 °C
+    uint32_t pollIntervals[NUM_MODBUS_DEVICES]; // Poll interval per device in ms
+    FilterConfig filters[NUM_SENSORS];         // Median and EMA per channel
+    uint32_t baudRate;                         // Bus speed (one of MODBUS_BAUD_RATES)
+};
+
+// Persistent configuration, stored as one NVS blob
+// Each older layout is the current one cut off before the field it lacks:
+// layout 1 has no filters, layout 2 no baud rate
+#define CONFIG_MAGIC 0x54483803 // "TH8", layout 3
+#define CONFIG_MAGIC_V2 0x54483802
+#define CONFIG_MAGIC_V1 0x54483801
+struct StoredConfig
+{
+    uint32_t magic;
+    SensorNameTable names;
+    AcquisitionSettings settings;
+};
+
+// Shared sensor state (lock-free snapshots, see SensorSnapshot.h)
+// Web server callbacks run on the AsyncTCP task and copy a consistent
+// set from here instead of reading half-updated globals.
+SnapshotBuffer<SensorSample> sensorReadings;     // Written by the acquisition task only
+SnapshotBuffer<SensorNameTable> sensorNameTable; // Written by initPreferences() / AsyncTCP handlers only
+SnapshotBuffer<AcquisitionSettings> acquisitionSettings; // Written by initPreferences(), the baud probe, then AsyncTCP handlers only
+
+// Firmware update (upload owned by the AsyncTCP task, restart and health check by loop())
+FirmwareUpdate firmwareUpdate;
+AsyncWebServerRequest *otaUploadRequest = nullptr; // Request currently streaming an image
+std::atomic<uint32_t> otaRebootAt(0);              // millis() of the pending restart (0 = none)
+bool otaPendingVerify = false;                     // Running image not confirmed yet
+
+// Pending configuration flash write (set by web handlers, committed by loop())
+std::atomic<bool> configDirty(false);
+std::atomic<uint32_t> configChangeTime(0); // millis() of the last change
+
+// Set while the acquisition task searches the bus speed; the task is the
+// settings writer until then and the web API refuses changes
+std::atomic<bool> baudProbeRunning(MODBUS_BAUD_AUTO_PROBE);
+
+// Random per boot (set in setup()): snapshot versions restart at 0 after a
+// reboot, the nonce keeps ETags of different boots apart
+uint32_t etagNonce = 0;
+
+// Pre-serialized /api/v1/sensordata response
+// Rendered once per sample cycle; the snapshot version doubles as ETag
+struct SensorDataJson
+{
+    uint16_t length;               // Payload length without terminator
+    char payload[JSON_CACHE_SIZE]; // JSON text, zero padded
+};
+SnapshotBuffer<SensorDataJson> sensorDataJson; // Written by the acquisition task only
+
+// Pre-rendered /api/v1/sensordata.bin response (same sample as the JSON)
+// Carries the sample timestamp, so the version changes with every cycle
+struct SensorDataBinary
+{
+    uint16_t length;                   // Payload length in bytes
+    uint8_t payload[BINARY_CACHE_SIZE];
+};
+SnapshotBuffer<SensorDataBinary> sensorDataBinary; // Written by the acquisition task only
+
+// Rolling statistics per sensor for /api/v1/statistics
+struct SensorStatistics
+{
+    int16_t raw[NUM_SENSORS];                                  // Last value before filtering (0.01 °C)
+    AggregateStats windows[NUM_SENSORS][NUM_STATISTICS_WINDOWS]; // Filtered values per window
+    unsigned long timestamp;                                   // millis() of the computation
+};
+SnapshotBuffer<SensorStatistics> sensorStatistics; // Written by the acquisition task only
+
+// Alarm state published by the acquisition task
+struct AlarmStatus
+{
+    uint32_t active;                 // Bit n = ALARM_RULES[n] active
+    uint32_t since[NUM_ALARM_RULES]; // millis() of the last change (0 = never)
+    uint32_t transitions;            // Changes since boot
+};
+SnapshotBuffer<AlarmStatus> alarmStatus; // Written by the acquisition task only
+
+// Fault counters of the bus participants for the metrics endpoints
+struct BusHealth
+{
+    LinkStats devices[NUM_MODBUS_DEVICES];
+    bool blockRead[NUM_MODBUS_DEVICES];
+    LinkStats channels[NUM_SENSORS];
+};
+SnapshotBuffer<BusHealth> busHealth; // Written by the acquisition task only
+
+// Local copies used by loop() to render the LCD
+SensorSample displaySample;
+SensorNameTable displayNames;
+AlarmStatus displayAlarms;
+uint32_t displayReadingsVersion = 0; // Snapshot versions shown on the LCD
+uint32_t displayNamesVersion = 0;
+uint32_t displayAlarmsVersion = 0;
+
+// Acquisition task state
+TaskHandle_t acquisitionTaskHandle = nullptr;  // Modbus polling task
+esp_timer_handle_t acquisitionTimer = nullptr; // One-shot wake-up for the next due device
+
+// Info items listed on the LCD after the sensors (see print_menu())
+enum MenuItem
+{
+    MENU_SEPARATOR,
+    MENU_IP_LABEL,
+    MENU_IP_VALUE,
+    MENU_VERSION,
+    MENU_ITEM_COUNT
+};
+
+// Scroll range: sensors followed by the menu items
+constexpr int DISPLAY_ITEM_COUNT = NUM_SENSORS + MENU_ITEM_COUNT;
+constexpr int MAX_DISPLAY_OFFSET = DISPLAY_ITEM_COUNT > LCD_ROWS ? DISPLAY_ITEM_COUNT - LCD_ROWS : 0;
+constexpr int MAX_DISPLAY_OFFSET_ALARM = DISPLAY_ITEM_COUNT > LCD_ROWS - 1 ? DISPLAY_ITEM_COUNT - (LCD_ROWS - 1) : 0; // Banner takes row 0
 
 // Display navigation state
 int displayOffset = 0;    // Current scroll position (first visible row)
-int maxDisplayOffset = 0; // Maximum scroll position
+bool displayDirty = true; // Redraw requested (new data, scroll, IP change)
+uint32_t displayedIP = 0; // IP address shown in the info menu
+bool splashVisible = true; // Welcome screen shown until the first sample arrives
+
+// Power management locks (nullptr in POWER_MODE_PERFORMANCE)
+esp_pm_lock_handle_t modbusSleepLock = nullptr; // No light sleep during a bus transaction
+esp_pm_lock_handle_t modbusApbLock = nullptr;   // Stable UART clock during a bus transaction
+
+// LCD backlight (owned by loop())
+bool backlightOn = true;
+unsigned long lastUserActivity = 0; // Timestamp of the last joystick input
+
+// Task running setup() and loop(); woken by wakeMainLoop()
+TaskHandle_t mainLoopTaskHandle = nullptr;
+bool joystickEventMode = false; // Joystick runs interrupt/timer driven, loop() may sleep
+
+// MQTT state (topics are fixed by initMqtt())
+TaskHandle_t mqttTaskHandle = nullptr; // Publisher task, woken after every changed sample
+char mqttDeviceId[24] = "";            // "thermohub8_" + last 3 bytes of the MAC address
+char mqttStateTopic[64] = "";
+char mqttStatusTopic[64] = "";
+char mqttAlarmTopic[64] = "";
+
+// WiFi state
+bool webServerStarted = false;          // Set once on the first IP (WiFi event task)
+unsigned long lastWiFiReconnect = 0;    // Timestamp of the last reconnect attempt (loop())
+
+// History recording (owned by loop())
+unsigned long lastHistoryUpdate = 0; // Timestamp of the last history row
+unsigned long lastFlashLogUpdate = 0; // Timestamp of the last flash log record
 
-// Timing control
-unsigned long lastModbusUpdate = 0; // Timestamp of last Modbus read
+// Live stream state (owned by loop())
+uint32_t streamReadingsVersion = 0;  // Last readings version pushed to the stream
+uint32_t streamNamesVersion = 0;     // Last name table version pushed to the stream
+uint32_t streamAlarmsVersion = 0;    // Last alarm state version pushed to the stream
+int32_t streamValues[NUM_SENSORS];   // Last pushed values in 0.01 °C (INT32_MIN = no value)
+uint8_t streamQuality[NUM_SENSORS];  // Last pushed quality bits
+
+// Bus scheduler state per entry of MODBUS_DEVICES (owned by the acquisition task)
+struct ModbusDeviceState
+{
+    int64_t nextPoll;     // esp_timer time (us) the device is due again
+    uint32_t interval;    // Current poll interval in ms (adaptive polling)
+    DeviceLink link;      // Block mode, backoff / circuit breaker (ModbusAcquisition)
+};
+ModbusDeviceState modbusDeviceStates[NUM_MODBUS_DEVICES];
+LinkHealth channelHealth[NUM_SENSORS]; // Per-channel backoff for single register reads
+SensorReading pollReference[NUM_SENSORS]; // Readings at the last significant change (adaptive polling)
+ChannelFilter sensorFilters[NUM_SENSORS];  // Median/EMA state per channel
+WindowAggregate sensorAggregates[NUM_SENSORS][NUM_STATISTICS_WINDOWS];
+int16_t rawValues[NUM_SENSORS];            // Last value before filtering
+AlarmEngine alarmEngine;                   // Evaluates ALARM_TABLE after every reading
+int64_t modbusBusIdleSince = 0;        // esp_timer time (us) the last transaction ended
+int64_t modbusTransactionStart = 0;    // esp_timer time (us) the current transaction started
+uint32_t modbusBaudRate = MODBUS_BAUDRATE; // Current UART speed (acquisition task after setup())
+SemaphoreHandle_t modbusFrameReceived = nullptr; // Given by the UART at the end of a frame (hardware mode)
+
+// ============================================================================
+// MAIN LOOP WAKE-UP
+// ============================================================================
+
+/**
+ * @brief Wake loop() early
+ *
+ * In joystick event mode loop() sleeps up to LOOP_IDLE_TIMEOUT between
+ * passes. Producers of work for loop() (new readings, renamed sensors,
+ * WiFi changes, joystick events) call this so it reacts immediately.
+ * Safe to call from any task (not from interrupts).
+ */
+void wakeMainLoop()
+{
+    if (mainLoopTaskHandle != nullptr)
+    {
+        xTaskNotifyGive(mainLoopTaskHandle);
+    }
+}
 
 // ============================================================================
 // RS485 CONTROL FUNCTIONS
@@ -147,635 +757,3391 @@ void postTransmission()
     digitalWrite(RS485_DE_RE_PIN, LOW);
 }
 
-// ============================================================================
-// MODBUS COMMUNICATION FUNCTIONS
-// ============================================================================
-
 /**
- * @brief Initialize Modbus communication interface
+ * @brief Discard a frame signal left over from a previous transaction
  *
- * Configures Serial2 for Modbus RTU communication and sets up
- * the MAX485 control pins.
+ * Pre-transmission callback in hardware direction mode, where the UART
+ * switches DE/RE itself.
  */
-void initModbus()
+void clearModbusFrame()
 {
-    Serial.println("Initializing Modbus...");
-
-    // Configure RS485 control pin
-    pinMode(RS485_DE_RE_PIN, OUTPUT);
-    digitalWrite(RS485_DE_RE_PIN, LOW); // Default to receive mode
+    xSemaphoreTake(modbusFrameReceived, 0);
+}
 
-    // Initialize Serial2 for Modbus communication
-    // 8 data bits, No parity, 1 stop bit (8N1)
-    Serial2.begin(MODBUS_BAUDRATE, SERIAL_8N1, RS485_RX_PIN, RS485_TX_PIN);
+/**
+ * @brief UART receive callback (hardware direction mode)
+ *
+ * Registered for the receive timeout only, i.e. it runs once the line
+ * was idle for MODBUS_RX_TIMEOUT characters after a response: the
+ * peripheral has found the end of the frame.
+ */
+void onModbusFrame()
+{
+    xSemaphoreGive(modbusFrameReceived);
+}
 
-    // Configure Modbus master
-    modbus.begin(MODBUS_SLAVE_ID, Serial2);
-    modbus.preTransmission(preTransmission);
-    modbus.postTransmission(postTransmission);
+// ============================================================================
+// WALL CLOCK
+// ============================================================================
 
-    Serial.println("Modbus initialized");
+/**
+ * @brief Current Unix time, once SNTP has set the clock
+ *
+ * @return uint32_t Seconds since 1970 (UTC), 0 while the clock is not set
+ */
+uint32_t wallClockTime()
+{
+    time_t now = time(nullptr);
+    return now >= CLOCK_MIN_VALID_TIME ? (uint32_t)now : 0;
 }
 
+// ============================================================================
+// SENSOR DATA CACHE
+// ============================================================================
+
 /**
- * @brief Read a 32-bit float value from two consecutive Modbus registers
+ * @brief Render the /api/v1/sensordata payloads into the cache
  *
- * Reads two 16-bit holding registers and combines them into a single
- * 32-bit float value using Big Endian byte order.
+ * Called by the acquisition task after every cycle. The JSON is only
+ * published if it differs from the cached one, so the cache version
+ * (ETag) changes exactly when the content changes, and only then the
+ * MQTT task is woken. Name changes show up with the next sample cycle.
+ * The binary payload is rendered from the same sample and published
+ * every cycle.
  *
- * @param registerAddress Starting register address
- * @return float Temperature value in °C, or -999.9 on error
+ * Format: see renderSensorDataJson() and renderSensorDataBinary()
+ *
+ * @param sample Sample set of the finished cycle
  */
-float readModbusFloat(uint16_t registerAddress)
+void updateSensorDataCache(const SensorSample &sample)
 {
-    uint8_t result;
-    uint16_t data[2];
+    // Task-owned render buffer, too large for the stack
+    static SensorDataJson cache;
+    SensorDataBinary binary;
 
-    // Read 2 consecutive registers (32-bit float = 2x 16-bit registers)
-    result = modbus.readHoldingRegisters(registerAddress, 2);
+    SensorNameTable table;
+    sensorNameTable.read(table);
 
-    if (result == modbus.ku8MBSuccess)
+    const char *names[NUM_SENSORS];
+    for (int i = 0; i < NUM_SENSORS; i++)
     {
-        // Get register values from response buffer
-        data[0] = modbus.getResponseBuffer(0); // High word
-        data[1] = modbus.getResponseBuffer(1); // Low word
-
-        // Convert Big Endian bytes to float
-        // First register contains high word, second contains low word
-        union
-        {
-            uint32_t i;
-            float f;
-        } converter;
-
-        converter.i = ((uint32_t)data[0] << 16) | data[1];
-        return converter.f;
+        names[i] = table.names[i];
     }
-    else
+
+    memset(&cache, 0, sizeof(cache));
+    cache.length = renderSensorDataJson(sample.readings, names, NUM_SENSORS, sample.timestamp,
+                                        cache.payload, sizeof(cache.payload));
+    if (sensorDataJson.publishIfChanged(cache) && mqttTaskHandle != nullptr)
     {
-        Serial.print("Modbus error reading register ");
-        Serial.println(registerAddress);
-        return -999.9; // Error indicator value
+        xTaskNotifyGive(mqttTaskHandle);
     }
+
+    binary.length = renderSensorDataBinary(sample.readings, NUM_SENSORS, sample.timestamp, wallClockTime(),
+                                           binary.payload, sizeof(binary.payload));
+    sensorDataBinary.publish(binary);
 }
 
 /**
- * @brief Update all sensor temperature readings via Modbus
+ * @brief Format the ETag of a sensor data cache version
  *
- * Periodically reads temperature values from all configured sensors.
- * Updates occur at intervals defined by MODBUS_UPDATE_INTERVAL.
- * Status LED blinks during Modbus communication.
+ * "<boot nonce>-<version>", so a client that kept an ETag across a
+ * reboot of the device cannot match a different sample.
  *
- * Note: Register addresses skip by 2 (every other register)
- * Example: Register 0x30, 0x32, 0x34, 0x36, etc.
+ * @param etag Output buffer (at least 20 bytes)
+ * @param size Size of the output buffer
+ * @param version Snapshot version of the cache
  */
-void updateSensorData()
+void formatSensorDataEtag(char *etag, size_t size, uint32_t version)
 {
-    unsigned long currentTime = millis();
+    snprintf(etag, size, "\"%08lx-%08lx\"", (unsigned long)etagNonce, (unsigned long)version);
+}
+
+/**
+ * @brief Send the cached sensor data payload
+ *
+ * Answers with 304 Not Modified if the client's If-None-Match matches
+ * the current cache version. Otherwise the cached JSON is written into
+ * a response stream sized for the payload, like sendSensorDataBinary():
+ * one buffer per response, no String and no serialization per request.
+ *
+ * @param request Incoming HTTP request
+ */
+void sendSensorDataJson(AsyncWebServerRequest *request)
+{
+    char etag[24];
+    formatSensorDataEtag(etag, sizeof(etag), sensorDataJson.version());
 
-    // Check if update interval has elapsed
-    if (currentTime - lastModbusUpdate >= MODBUS_UPDATE_INTERVAL)
+    if (request->hasHeader("If-None-Match") &&
+        request->getHeader("If-None-Match")->value().indexOf(etag) >= 0)
     {
-        lastModbusUpdate = currentTime;
+        AsyncWebServerResponse *response = request->beginResponse(304);
+        response->addHeader("ETag", etag);
+        request->send(response);
+        return;
+    }
 
-        // Read all configured sensors
-        for (int i = 0; i < NUM_SENSORS; i++)
-        {
-            // Calculate register address: start + (sensor_index * 2)
-            // Registers are spaced 2 apart
-            uint16_t registerAddr = MODBUS_START_REGISTER + (i * 2);
+    // Owned by the AsyncTCP task (the only caller), too large for the stack
+    static SensorDataJson cache;
+    uint32_t version = sensorDataJson.read(cache);
 
-            // Indicate Modbus activity with LED
-            digitalWrite(STATUS_LED, HIGH);
-            float temp = readModbusFloat(registerAddr);
-            digitalWrite(STATUS_LED, LOW);
+    // The payload may be newer than the version checked above
+    formatSensorDataEtag(etag, sizeof(etag), version);
 
-            // Update sensor value if read was successful
-            if (temp != -999.9)
-            {
-                sensorTemperatures[i] = temp;
-            }
-        }
-    }
+    // The response keeps its own copy, the snapshot may change while it is sent
+    AsyncResponseStream *response = request->beginResponseStream("application/json", JSON_CACHE_SIZE);
+    response->write((const uint8_t *)cache.payload, min((size_t)cache.length, sizeof(cache.payload)));
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
 }
 
-// ============================================================================
-// NON-VOLATILE STORAGE FUNCTIONS
-// ============================================================================
-
 /**
- * @brief Initialize preferences (non-volatile storage) and load sensor names
+ * @brief Send the cached binary sensor data payload
  *
- * Opens the "thermohub8" namespace in ESP32 flash memory and loads
- * all sensor names. If a name doesn't exist, creates a default name.
+ * Same validator logic as sendSensorDataJson(); the version changes
+ * with every sample cycle, so a 304 means no new sample yet.
+ *
+ * @param request Incoming HTTP request
  */
-void initPreferences()
+void sendSensorDataBinary(AsyncWebServerRequest *request)
 {
-    Serial.println("Initializing Preferences...");
-    preferences.begin("thermohub8", false); // false = read/write mode
+    char etag[24];
+    formatSensorDataEtag(etag, sizeof(etag), sensorDataBinary.version());
 
-    // Load or create default sensor names
-    for (int i = 0; i < NUM_SENSORS; i++)
+    if (request->hasHeader("If-None-Match") &&
+        request->getHeader("If-None-Match")->value().indexOf(etag) >= 0)
     {
-        String key = "sensor" + String(i);
-        String defaultName = "Sensor " + String(i + 1);
-        sensorNames[i] = preferences.getString(key.c_str(), defaultName);
-
-        Serial.print("Sensor ");
-        Serial.print(i);
-        Serial.print(": ");
-        Serial.println(sensorNames[i]);
+        AsyncWebServerResponse *response = request->beginResponse(304);
+        response->addHeader("ETag", etag);
+        request->send(response);
+        return;
     }
+
+    SensorDataBinary binary;
+    uint32_t version = sensorDataBinary.read(binary);
+    formatSensorDataEtag(etag, sizeof(etag), version);
+
+    // The response keeps its own copy, the snapshot may change while it is sent
+    AsyncResponseStream *response = request->beginResponseStream("application/octet-stream", BINARY_CACHE_SIZE);
+    response->write(binary.payload, binary.length);
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
 }
 
+// ============================================================================
+// FILTERING AND STATISTICS
+// ============================================================================
+
 /**
- * @brief Save a sensor name to non-volatile storage
+ * @brief Filter a channel's new reading and add it to the statistics
  *
- * Stores the sensor name in ESP32 flash memory so it persists
- * across power cycles.
+ * Called by the acquisition task right after updateReading(). Only a
+ * value read in this cycle passes the filter; the published centi is
+ * replaced by the filtered value, the raw one is kept for
+ * /api/v1/statistics. Once the hold time expired without a good read,
+ * the filter starts over, so a reconnected sensor does not continue
+ * from an old average.
  *
- * @param sensorIndex Index of the sensor (0 to NUM_SENSORS-1)
- * @param name New name for the sensor (max MAX_SENSOR_NAME_LENGTH chars)
+ * @param channel Sensor index
+ * @param reading Reading updated this cycle
+ * @param config Filter setting of the channel
+ * @param now Cycle timestamp (millis())
  */
-void saveSensorName(int sensorIndex, String name)
+void filterReading(int channel, SensorReading &reading, const FilterConfig &config, uint32_t now)
 {
-    // Validate sensor index
-    if (sensorIndex >= 0 && sensorIndex < NUM_SENSORS)
+    ChannelFilter &filter = sensorFilters[channel];
+    filter.configure(config);
+
+    if (!(reading.quality & QUALITY_OK))
     {
-        // Truncate name if too long
-        if (name.length() > MAX_SENSOR_NAME_LENGTH)
+        if (!hasValue(reading))
         {
-            name = name.substring(0, MAX_SENSOR_NAME_LENGTH);
+            filter.reset();
         }
+        return;
+    }
 
-        // Save to flash memory
-        String key = "sensor" + String(sensorIndex);
-        preferences.putString(key.c_str(), name);
-        sensorNames[sensorIndex] = name;
+    rawValues[channel] = reading.centi;
+    reading.centi = filter.apply(reading.centi);
 
-        Serial.print("Sensor name saved: ");
-        Serial.print(sensorIndex);
-        Serial.print(" = ");
-        Serial.println(name);
+    for (int w = 0; w < NUM_STATISTICS_WINDOWS; w++)
+    {
+        sensorAggregates[channel][w].add(now, reading.centi);
     }
 }
 
-// ============================================================================
-// LCD DISPLAY FUNCTIONS
-// ============================================================================
-
 /**
- * @brief Initialize the LCD display
+ * @brief Publish the current window statistics of all channels
  *
- * Sets up I2C communication, initializes the LCD, displays a welcome
- * message, and calculates the maximum scroll offset based on the
- * number of sensors.
+ * Called by the acquisition task after every device cycle. Merging the
+ * buckets costs AGGREGATE_BUCKETS steps per channel and window, the
+ * web handler only copies the result.
+ *
+ * @param now Cycle timestamp (millis())
  */
-void initDisplay()
+void updateSensorStatistics(uint32_t now)
 {
-    Serial.println("Initializing LCD...");
-
-    // Initialize I2C bus
-    Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN);
-
-    // Initialize LCD display
-    lcd.init();
-    lcd.backlight();
-    lcd.clear();
-
-    // Display welcome message
-    lcd.setCursor(1, 0);
-    lcd.print("Thermohub8");
-    lcd.setCursor(-4, 2); // Using offset workaround for row 2
-    lcd.print("Developed by");
-    lcd.setCursor(-4, 3); // Using offset workaround for row 3
-    lcd.print("Johannes    v1.0");
-
-    delay(2000);
-    lcd.clear();
-
-    // Calculate maximum scroll position
-    // Total scrollable items = sensors + menu items (separator + IP + IP value + version)
-    maxDisplayOffset = max(0, NUM_SENSORS - LCD_ROWS);
+    SensorStatistics statistics;
 
-    Serial.println("LCD initialized");
+    for (int i = 0; i < NUM_SENSORS; i++)
+    {
+        statistics.raw[i] = rawValues[i];
+        for (int w = 0; w < NUM_STATISTICS_WINDOWS; w++)
+        {
+            statistics.windows[i][w] = sensorAggregates[i][w].stats(now);
+        }
+    }
+    statistics.timestamp = now;
+    sensorStatistics.publish(statistics);
 }
 
 /**
- * @brief Print sensor data to LCD at current cursor position
+ * @brief Send the rolling statistics of all sensors
  *
- * Displays sensor name (truncated to DISPLAY_NAME_LENGTH) followed by
- * temperature value with one decimal place and °C symbol.
+ * Format: {"timestamp":123456,"windows":[60,300,3600],
+ *          "sensors":[{"id":0,"name":"Flow","value":23.45,"raw":23.47,
+ *                      "windows":[{"min":23.1,"max":23.9,"mean":23.44,"count":300},...]},...]}
  *
- * Format: "SensName  XX.X°C"
+ * Values in °C with 0.01 resolution; null if there is no value (yet).
+ * Windows are given in seconds and cover between 11/12 and the full
+ * length (see WindowAggregate).
  *
- * @param sensorIndex Index of the sensor to display
+ * @param request Incoming HTTP request
  */
-void print_sensordata(int sensorIndex)
+void sendSensorStatistics(AsyncWebServerRequest *request)
 {
-    // Get and truncate sensor name if needed
-    String displayName = sensorNames[sensorIndex];
-    if (displayName.length() > DISPLAY_NAME_LENGTH)
-    {
-        displayName = displayName.substring(0, DISPLAY_NAME_LENGTH);
-    }
-    lcd.print(displayName);
+    SensorStatistics statistics;
+    SensorSample sample;
+    SensorNameTable table;
+    sensorStatistics.read(statistics);
+    sensorReadings.read(sample);
+    sensorNameTable.read(table);
 
-    // Pad name with spaces to align temperature (right-aligned)
-    for (int i = displayName.length(); i < DISPLAY_NAME_LENGTH; i++)
+    StaticJsonDocument<STATISTICS_JSON_SIZE> doc;
+    doc["timestamp"] = statistics.timestamp;
+    JsonArray windows = doc.createNestedArray("windows");
+    for (int w = 0; w < NUM_STATISTICS_WINDOWS; w++)
     {
-        lcd.print(" ");
+        windows.add(STATISTICS_WINDOWS[w] / 1000);
     }
-    lcd.print(" ");
 
-    // Display temperature value
-    float temp = sensorTemperatures[sensorIndex];
-    if (temp > -99.0)
+    JsonArray sensors = doc.createNestedArray("sensors");
+    for (int i = 0; i < NUM_SENSORS; i++)
     {
-        // Add leading space for positive temperatures
-        if (temp > 0)
-            lcd.print(" ");
-        // Add leading space for single-digit temperatures
-        if (temp > -10.0 && temp < 10.0)
-            lcd.print(" ");
-
-        // Print temperature with 1 decimal place
-        lcd.print(temp, 1);
-        lcd.print((char)223); // Degree symbol '°'
-        lcd.print("C");
-    }
-    else
+        JsonObject sensor = sensors.createNestedObject();
+        sensor["id"] = i;
+        sensor["name"] = table.names[i];
+        if (hasValue(sample.readings[i]))
+        {
+            sensor["value"] = sample.readings[i].centi / 100.0;
+        }
+        else
+        {
+            sensor["value"] = nullptr;
+        }
+        if (statistics.raw[i] != SENSOR_BINARY_NO_VALUE)
+        {
+            sensor["raw"] = statistics.raw[i] / 100.0;
+        }
+        else
+        {
+            sensor["raw"] = nullptr;
+        }
+
+        JsonArray sensorWindows = sensor.createNestedArray("windows");
+        for (int w = 0; w < NUM_STATISTICS_WINDOWS; w++)
+        {
+            const AggregateStats &stats = statistics.windows[i][w];
+            JsonObject window = sensorWindows.createNestedObject();
+            if (stats.count > 0)
+            {
+                window["min"] = stats.min / 100.0;
+                window["max"] = stats.max / 100.0;
+                window["mean"] = stats.mean / 100.0;
+            }
+            else
+            {
+                window["min"] = nullptr;
+                window["max"] = nullptr;
+                window["mean"] = nullptr;
+            }
+            window["count"] = stats.count;
+        }
+    }
+
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    serializeJson(doc, *response);
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+}
+
+// ============================================================================
+// ALARM FUNCTIONS
+// ============================================================================
+
+const char *const ALARM_TYPE_NAMES[ALARM_TYPE_COUNT] = {"high", "low", "rise", "fall"};
+
+/**
+ * @brief Set up the alarm outputs and the rule engine
+ *
+ * Output GPIOs start inactive. Called from setup() before the
+ * acquisition task starts.
+ */
+void initAlarms()
+{
+    Serial.println("Initializing Alarms...");
+
+    for (const AlarmRule &rule : ALARM_RULES)
+    {
+        if (rule.output >= 0)
+        {
+            pinMode(rule.output, OUTPUT);
+            digitalWrite(rule.output, !ALARM_OUTPUT_ACTIVE);
+        }
+    }
+
+    alarmEngine.begin(ALARM_TABLE.alarms, NUM_ALARM_RULES, ALARM_RATE_WINDOW);
+
+    AlarmStatus status;
+    memset(&status, 0, sizeof(status));
+    alarmStatus.publish(status);
+
+    Serial.print("Alarm rules: ");
+    Serial.println(NUM_ALARM_RULES);
+}
+
+/**
+ * @brief Drive the outputs and publish the state after an alarm changed
+ *
+ * Runs on the acquisition task right after the evaluation. An output
+ * shared by several rules stays active while any of them is active.
+ * The MQTT task is woken directly; loop() picks the new state up for
+ * the LCD and the stream when the acquisition task wakes it after the
+ * cycle.
+ *
+ * @param previous Active rules before this cycle
+ */
+void applyAlarms(uint32_t previous)
+{
+    uint32_t active = alarmEngine.activeMask();
+
+    for (int i = 0; i < NUM_ALARM_RULES; i++)
+    {
+        int8_t output = ALARM_RULES[i].output;
+        if (output < 0)
+        {
+            continue;
+        }
+        bool on = false;
+        for (int j = 0; j < NUM_ALARM_RULES; j++)
+        {
+            on = on || (ALARM_RULES[j].output == output && (active & (1UL << j)));
+        }
+        digitalWrite(output, on ? ALARM_OUTPUT_ACTIVE : !ALARM_OUTPUT_ACTIVE);
+    }
+    digitalWrite(STATUS_LED, active != 0 ? HIGH : LOW);
+
+    AlarmStatus status;
+    status.active = active;
+    for (int i = 0; i < NUM_ALARM_RULES; i++)
+    {
+        status.since[i] = alarmEngine.since(i);
+    }
+    status.transitions = alarmEngine.transitions();
+    alarmStatus.publish(status);
+
+    for (int i = 0; i < NUM_ALARM_RULES; i++)
+    {
+        if ((active ^ previous) & (1UL << i))
+        {
+            Serial.print("Alarm ");
+            Serial.print(ALARM_RULES[i].label);
+            Serial.println((active & (1UL << i)) ? ": active" : ": cleared");
+        }
+    }
+
+    if (mqttTaskHandle != nullptr)
+    {
+        xTaskNotifyGive(mqttTaskHandle);
+    }
+}
+
+/**
+ * @brief Render the alarm state as JSON
+ *
+ * Shared by /api/v1/alarms, the "alarms" stream event and the MQTT
+ * alarm topic.
+ *
+ * Format: {"active":1,"alarms":[{"id":0,"label":"Overheat","sensor":0,"type":"high",
+ *          "threshold":95.0,"hysteresis":2.0,"active":true,"since":12345},...]}
+ *
+ * @param status Alarm state
+ * @param out Output buffer
+ * @param size Buffer size
+ * @return size_t Text length without terminator
+ */
+size_t renderAlarmJson(const AlarmStatus &status, char *out, size_t size)
+{
+    StaticJsonDocument<ALARM_JSON_SIZE> doc;
+    doc["active"] = __builtin_popcount(status.active);
+
+    JsonArray alarms = doc.createNestedArray("alarms");
+    for (int i = 0; i < NUM_ALARM_RULES; i++)
+    {
+        const AlarmRule &rule = ALARM_RULES[i];
+        JsonObject alarm = alarms.createNestedObject();
+        alarm["id"] = i;
+        alarm["label"] = rule.label;
+        alarm["sensor"] = rule.sensor;
+        alarm["type"] = ALARM_TYPE_NAMES[rule.type];
+        alarm["threshold"] = rule.threshold;
+        alarm["hysteresis"] = rule.hysteresis;
+        alarm["active"] = (status.active & (1UL << i)) != 0;
+        alarm["since"] = status.since[i];
+    }
+    return serializeJson(doc, out, size);
+}
+
+/**
+ * @brief Send the current alarm state
+ *
+ * @param request Incoming HTTP request
+ */
+void sendAlarms(AsyncWebServerRequest *request)
+{
+    AlarmStatus status;
+    alarmStatus.read(status);
+
+    char payload[ALARM_JSON_SIZE];
+    size_t length = renderAlarmJson(status, payload, sizeof(payload));
+
+    AsyncResponseStream *response = request->beginResponseStream("application/json", length);
+    response->write((const uint8_t *)payload, length);
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+}
+
+// ============================================================================
+// LIVE STREAM (SERVER-SENT EVENTS)
+// ============================================================================
+
+/**
+ * @brief Send the complete current state to a newly connected client
+ *
+ * Runs on the AsyncTCP task. Uses the cached sensordata payload so the
+ * client starts with the same document /api/v1/sensordata would return,
+ * followed by the current alarm state.
+ *
+ * @param client Newly connected event source client
+ */
+void onStreamConnect(AsyncEventSourceClient *client)
+{
+    String body;
+    uint32_t version = sensorDataJson.readWith([&body](const SensorDataJson &cache)
+                                               {
+        body = String();
+        body.concat(cache.payload, min((size_t)cache.length, sizeof(cache.payload))); });
+
+    client->send(body.c_str(), "readings", version);
+
+    AlarmStatus status;
+    alarmStatus.read(status);
+    char payload[ALARM_JSON_SIZE];
+    renderAlarmJson(status, payload, sizeof(payload));
+    client->send(payload, "alarms");
+}
+
+/**
+ * @brief Push the alarm state to all stream clients after a change
+ *
+ * Called from loop(), which the acquisition task wakes right after the
+ * cycle that changed an alarm.
+ *
+ * Event "alarms": same document as /api/v1/alarms
+ */
+void publishStreamAlarms()
+{
+    if (alarmStatus.version() == streamAlarmsVersion)
+    {
+        return;
+    }
+
+    AlarmStatus status;
+    streamAlarmsVersion = alarmStatus.read(status);
+    if (events.count() == 0)
+    {
+        return;
+    }
+
+    char payload[ALARM_JSON_SIZE];
+    renderAlarmJson(status, payload, sizeof(payload));
+    events.send(payload, "alarms", streamAlarmsVersion);
+}
+
+/**
+ * @brief Push changed readings to all stream clients
+ *
+ * Called from loop(). Reports by exception: only sensors whose value
+ * moved by at least REPORT_DEADBAND since it was last pushed, or whose
+ * status changed, are sent. After a rename all sensors are sent
+ * including their names.
+ *
+ * Event "readings": {"sensors":[{"id":0,"value":23.5,"status":"ok"},...]}
+ */
+void publishStreamUpdates()
+{
+    uint32_t readingsVersion = sensorReadings.version();
+    uint32_t namesVersion = sensorNameTable.version();
+
+    if (readingsVersion == streamReadingsVersion && namesVersion == streamNamesVersion)
+    {
+        return;
+    }
+
+    SensorSample sample;
+    SensorNameTable table;
+    streamReadingsVersion = sensorReadings.read(sample);
+    bool namesChanged = (namesVersion != streamNamesVersion);
+    if (namesChanged)
+    {
+        streamNamesVersion = sensorNameTable.read(table);
+    }
+
+    StaticJsonDocument<STREAM_EVENT_SIZE> doc;
+    JsonArray sensors = doc.createNestedArray("sensors");
+    int changed = 0;
+
+    for (int i = 0; i < NUM_SENSORS; i++)
+    {
+        const SensorReading &reading = sample.readings[i];
+        int32_t value = hasValue(reading) ? reading.centi : INT32_MIN;
+        bool significant = (value == INT32_MIN || streamValues[i] == INT32_MIN)
+                               ? value != streamValues[i]
+                               : abs(value - streamValues[i]) >= REPORT_DEADBAND;
+        if (!significant && reading.quality == streamQuality[i] && !namesChanged)
+        {
+            continue;
+        }
+        streamValues[i] = value;
+        streamQuality[i] = reading.quality;
+        changed++;
+
+        JsonObject sensor = sensors.createNestedObject();
+        sensor["id"] = i;
+        if (value != INT32_MIN)
+        {
+            char text[8];
+            size_t length = formatDeci(toDeci(value), text);
+            sensor["value"] = serialized(text, length);
+        }
+        else
+        {
+            sensor["value"] = nullptr;
+        }
+        sensor["status"] = qualityName(reading.quality);
+        if (namesChanged)
+        {
+            sensor["name"] = table.names[i];
+        }
+    }
+
+    // Nothing to send, or nobody listening (values are still tracked)
+    if (changed == 0 || events.count() == 0)
+    {
+        return;
+    }
+
+    char payload[STREAM_EVENT_SIZE];
+    serializeJson(doc, payload, sizeof(payload));
+    events.send(payload, "readings", streamReadingsVersion);
+}
+
+// ============================================================================
+// MODBUS COMMUNICATION FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Modbus idle callback
+ *
+ * Called by ModbusMaster while waiting for a response. Yields the CPU
+ * when no byte is pending so the acquisition task does not starve
+ * other tasks on its core during long slave timeouts.
+ *
+ * In hardware direction mode the UART hands the response over in one
+ * piece at the end of the frame, so the task sleeps until then instead
+ * of checking Serial2 every tick. The wait is bounded to keep the
+ * ModbusMaster response timeout working.
+ */
+void modbusIdle()
+{
+    if (!Serial2.available())
+    {
+        if (modbusFrameReceived != nullptr)
+        {
+            xSemaphoreTake(modbusFrameReceived, pdMS_TO_TICKS(10));
+        }
+        else
+        {
+            vTaskDelay(1);
+        }
+    }
+}
+
+/**
+ * @brief Check a bus speed from the configuration
+ *
+ * @return true if baud is one of MODBUS_BAUD_RATES
+ */
+bool isValidModbusBaudRate(uint32_t baud)
+{
+    for (uint32_t rate : MODBUS_BAUD_RATES)
+    {
+        if (rate == baud)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Switch the UART to another bus speed
+ *
+ * Called between transactions only (setup() or the acquisition task).
+ *
+ * @param baud New speed (one of MODBUS_BAUD_RATES)
+ */
+void setModbusBaudRate(uint32_t baud)
+{
+    Serial2.updateBaudRate(baud);
+    modbusBaudRate = baud;
+
+    Serial.print("Modbus speed ");
+    Serial.print(baud);
+    Serial.println(" baud");
+}
+
+/**
+ * @brief Initialize Modbus communication interface
+ *
+ * Configures Serial2 for Modbus RTU communication at the configured
+ * speed and sets up the MAX485 control pins. With MODBUS_HW_DIRECTION
+ * the DE/RE pin is the UART's RTS line in RS485 half-duplex mode: the
+ * peripheral enables the driver exactly for the duration of the frame
+ * and detects the end of a response by its receive timeout, so neither
+ * direction switching nor frame detection depends on task scheduling.
+ */
+void initModbus()
+{
+    Serial.println("Initializing Modbus...");
+
+    AcquisitionSettings settings;
+    acquisitionSettings.read(settings);
+    modbusBaudRate = settings.baudRate;
+
+    // Initialize Serial2 for Modbus communication
+    // 8 data bits, No parity, 1 stop bit (8N1)
+    Serial2.begin(modbusBaudRate, SERIAL_8N1, RS485_RX_PIN, RS485_TX_PIN);
+
+    // Configure Modbus master (slave ID is switched per transaction)
+    modbus.begin(MODBUS_DEVICES[0].slaveId, Serial2);
+    modbus.idle(modbusIdle);
+
+    if (MODBUS_HW_DIRECTION)
+    {
+        modbusFrameReceived = xSemaphoreCreateBinary();
+        Serial2.setPins(RS485_RX_PIN, RS485_TX_PIN, -1, RS485_DE_RE_PIN);
+        Serial2.setMode(UART_MODE_RS485_HALF_DUPLEX);
+        Serial2.setRxTimeout(MODBUS_RX_TIMEOUT);
+        Serial2.onReceive(onModbusFrame, true);
+        modbus.preTransmission(clearModbusFrame);
+    }
+    else
+    {
+        // Configure RS485 control pin
+        pinMode(RS485_DE_RE_PIN, OUTPUT);
+        digitalWrite(RS485_DE_RE_PIN, LOW); // Default to receive mode
+        modbus.preTransmission(preTransmission);
+        modbus.postTransmission(postTransmission);
+    }
+
+    Serial.print("Modbus initialized at ");
+    Serial.print(modbusBaudRate);
+    Serial.println(MODBUS_HW_DIRECTION ? " baud, hardware direction control" : " baud");
+}
+
+/**
+ * @brief Minimum silent interval between two Modbus RTU frames
+ *
+ * 3.5 character times (11 bits per character in RTU framing) at the
+ * current speed. Above 19200 baud the specification fixes the gap at
+ * 1750 us.
+ *
+ * @return uint32_t Gap in microseconds
+ */
+uint32_t modbusFrameGap()
+{
+    return modbusBaudRate > 19200 ? 1750 : 38500000UL / modbusBaudRate;
+}
+
+/**
+ * @brief Wait for the inter-frame gap before the next request
+ *
+ * ModbusMaster returns as soon as a response is complete, so the next
+ * request could otherwise start before other slaves recognized the end
+ * of the previous frame. Waits only for the remainder of the gap, which
+ * keeps transactions to different slaves back-to-back.
+ */
+void beginModbusTransaction()
+{
+    int64_t elapsed = esp_timer_get_time() - modbusBusIdleSince;
+    uint32_t gap = modbusFrameGap();
+    if (elapsed < gap)
+    {
+        delayMicroseconds(gap - elapsed);
+    }
+
+    modbusTransactionStart = esp_timer_get_time();
+}
+
+/**
+ * @brief Record the end of a transaction
+ *
+ * Marks the start of the inter-frame gap and updates the transaction
+ * latency histogram and the result counters.
+ *
+ * @param result ModbusMaster result code of the transaction
+ */
+void endModbusTransaction(uint8_t result)
+{
+    modbusBusIdleSince = esp_timer_get_time();
+    metrics.modbusTransaction.record((uint32_t)(modbusBusIdleSince - modbusTransactionStart));
+
+    switch (result)
+    {
+    case ModbusMaster::ku8MBSuccess:
+        metrics.modbusSuccess++;
+        break;
+    case ModbusMaster::ku8MBResponseTimedOut:
+        metrics.modbusTimeouts++;
+        break;
+    case ModbusMaster::ku8MBInvalidCRC:
+        metrics.modbusCrcErrors++;
+        break;
+    case ModbusMaster::ku8MBIllegalFunction:
+    case ModbusMaster::ku8MBIllegalDataAddress:
+    case ModbusMaster::ku8MBIllegalDataValue:
+    case ModbusMaster::ku8MBSlaveDeviceFailure:
+        metrics.modbusExceptions++;
+        break;
+    default:
+        metrics.modbusOtherErrors++;
+        break;
+    }
+}
+
+/**
+ * @brief ModbusTransport that keeps the bus timing and the metrics
+ *
+ * Every request of the shared acquisition code (ModbusAcquisition) goes
+ * through beginModbusTransaction() and endModbusTransaction(), so the
+ * inter-frame gap, the latency histogram and the result counters cover
+ * retries, single reads and probes alike.
+ */
+class MeteredModbusTransport : public ModbusTransport
+{
+public:
+    uint8_t readRegisters(uint8_t slaveId, ModbusRegisterType type, uint16_t address,
+                          uint16_t count, uint16_t *words) override
+    {
+        beginModbusTransaction();
+        uint8_t result = modbusTransport.readRegisters(slaveId, type, address, count, words);
+        endModbusTransaction(result);
+        return result;
+    }
+};
+
+MeteredModbusTransport meteredModbusTransport;
+ModbusAcquisition modbusAcquisition(meteredModbusTransport, MODBUS_LINK_POLICY, MODBUS_RETRIES);
+
+/**
+ * @brief Describe a device for ModbusAcquisition
+ *
+ * @param index Entry in MODBUS_DEVICES
+ * @return AcquisitionDevice Slave, register table and block of the device
+ */
+AcquisitionDevice acquisitionDevice(int index)
+{
+    const ModbusDevice &device = MODBUS_DEVICES[index];
+    const ModbusDeviceLayout &layout = MODBUS_LAYOUT.devices[index];
+    return {device.slaveId, device.registerType, &SENSOR_CHANNELS[layout.firstChannel], layout.channels,
+            layout.firstRegister, layout.registerCount};
+}
+
+/**
+ * @brief Find the bus speed if no module answers at the configured one
+ *
+ * Runs once at the start of acquisitionTask() with
+ * MODBUS_BAUD_AUTO_PROBE: every device is tried at the configured speed,
+ * then at the other supported speeds until one answers. A found speed
+ * is stored like a change via the API; until the probe is done
+ * (baudProbeRunning) the web API leaves the settings alone, so there is
+ * still a single writer. Each unanswered try costs a response timeout,
+ * so a bus without any module delays the first readings (not setup())
+ * by up to NUM_MODBUS_BAUD_RATES * NUM_MODBUS_DEVICES * 2 s.
+ */
+void probeModbusBaudRate()
+{
+    uint32_t configured = modbusBaudRate;
+    uint32_t candidates[NUM_MODBUS_BAUD_RATES];
+    int count = 0;
+    candidates[count++] = configured;
+    for (uint32_t rate : MODBUS_BAUD_RATES)
+    {
+        if (rate != configured)
+        {
+            candidates[count++] = rate;
+        }
+    }
+
+    for (int c = 0; c < count; c++)
+    {
+        if (candidates[c] != modbusBaudRate)
+        {
+            setModbusBaudRate(candidates[c]);
+        }
+        for (int i = 0; i < (int)NUM_MODBUS_DEVICES; i++)
+        {
+            if (!modbusAcquisition.answers(acquisitionDevice(i)))
+            {
+                continue;
+            }
+            if (modbusBaudRate != configured)
+            {
+                AcquisitionSettings settings;
+                acquisitionSettings.read(settings);
+                settings.baudRate = modbusBaudRate;
+                acquisitionSettings.publish(settings);
+
+                // Written by loop() like an API change (see scheduleConfigCommit())
+                configChangeTime = millis();
+                configDirty = true;
+            }
+            return;
+        }
+    }
+
+    Serial.println("No Modbus module answers, keeping the configured speed");
+    setModbusBaudRate(configured);
+}
+
+/**
+ * @brief Read all channels of one device via Modbus
+ *
+ * Called by the bus scheduler when the device is due.
+ * Status LED is lit during Modbus communication.
+ *
+ * The bus side (block read, fallback to single reads after an
+ * exception response, retries, LinkHealth of the device and its
+ * channels) is ModbusAcquisition::poll(), shared with the native
+ * benchmark; this function logs the outcome and processes the values.
+ *
+ * Register addresses, formats and scales come from SENSOR_CHANNELS.
+ * New values pass the channel's filter (filterReading()) and are then
+ * checked against the alarm rules, so an alarm reacts within the same
+ * cycle (applyAlarms()).
+ *
+ * @param index Entry in MODBUS_DEVICES
+ * @param sample Sample set receiving the device's channels
+ * @param settings Current calibration offsets and filters
+ */
+void acquireDeviceData(int index, SensorSample &sample, const AcquisitionSettings &settings)
+{
+    const ModbusDevice &device = MODBUS_DEVICES[index];
+    const ModbusDeviceLayout &layout = MODBUS_LAYOUT.devices[index];
+    ModbusDeviceState &state = modbusDeviceStates[index];
+    float values[NUM_SENSORS];
+    bool valid[NUM_SENSORS];
+
+    // Indicate Modbus activity with LED
+    digitalWrite(STATUS_LED, HIGH);
+
+    DevicePoll poll = modbusAcquisition.poll(acquisitionDevice(index), state.link, &channelHealth[layout.firstChannel],
+                                             millis(), settings.pollIntervals[index], values, valid);
+    metrics.modbusRetries = modbusAcquisition.retries();
+
+    if (poll.blockResult != modbus.ku8MBSuccess)
+    {
+        Serial.print("Modbus block read from slave ");
+        Serial.print(device.slaveId);
+        Serial.print(" failed, error 0x");
+        Serial.println(poll.blockResult, HEX);
+    }
+    if (poll.blockDisabled)
+    {
+        Serial.print("Modbus block read not supported by slave ");
+        Serial.print(device.slaveId);
+        Serial.println(", using single register reads");
+    }
+    if (poll.channelError != modbus.ku8MBSuccess)
+    {
+        Serial.print("Modbus single read from slave ");
+        Serial.print(device.slaveId);
+        Serial.print(" failed, error 0x");
+        Serial.println(poll.channelError, HEX);
+    }
+    if (poll.tripped)
+    {
+        Serial.print("Modbus slave ");
+        Serial.print(device.slaveId);
+        Serial.println(" not responding, probing every " + String(MODBUS_PROBE_INTERVAL / 1000) + " s");
+    }
+
+    // The LED stays lit while an alarm is active
+    digitalWrite(STATUS_LED, alarmEngine.activeMask() != 0 ? HIGH : LOW);
+
+    sample.timestamp = millis();
+    uint32_t holdTime = SENSOR_STALE_CYCLES * state.interval;
+    uint32_t alarmsBefore = alarmEngine.activeMask();
+    for (int i = 0; i < layout.channels; i++)
+    {
+        int channel = layout.firstChannel + i;
+        SensorReading &reading = sample.readings[channel];
+        updateReading(reading, valid[i], values[i], settings.offsets[channel], sample.timestamp, holdTime);
+        filterReading(channel, reading, settings.filters[channel], sample.timestamp);
+
+        if (reading.quality & QUALITY_OK)
+        {
+            alarmEngine.evaluate(channel, reading.centi, sample.timestamp);
+        }
+    }
+
+    if (alarmEngine.activeMask() != alarmsBefore)
+    {
+        applyAlarms(alarmsBefore);
+    }
+}
+
+/**
+ * @brief Select the device to read next
+ *
+ * Among all devices that are due, the one with the highest priority
+ * wins; equal priorities are served in order of their due time.
+ *
+ * @param now Current esp_timer time in microseconds
+ * @param wait Set to the time until the next device is due if none is due
+ * @return int Entry in MODBUS_DEVICES, or -1 if no device is due
+ */
+int selectDueDevice(int64_t now, int64_t &wait)
+{
+    int selected = -1;
+    int64_t nextDue = INT64_MAX;
+
+    for (int i = 0; i < (int)NUM_MODBUS_DEVICES; i++)
+    {
+        const ModbusDeviceState &state = modbusDeviceStates[i];
+        nextDue = min(nextDue, state.nextPoll);
+
+        if (state.nextPoll > now)
+        {
+            continue;
+        }
+        if (selected < 0 ||
+            MODBUS_DEVICES[i].priority > MODBUS_DEVICES[selected].priority ||
+            (MODBUS_DEVICES[i].priority == MODBUS_DEVICES[selected].priority &&
+             state.nextPoll < modbusDeviceStates[selected].nextPoll))
+        {
+            selected = i;
+        }
+    }
+
+    wait = nextDue - now;
+    return selected;
+}
+
+/**
+ * @brief Choose the next poll interval of a device from its readings
+ *
+ * Any channel that moved by ADAPTIVE_DEADBAND since the last significant
+ * change, or changed its quality, resets the device to its configured
+ * interval. Otherwise the interval doubles up to ADAPTIVE_MAX_INTERVAL.
+ * Slow drift accumulates against the reference and still triggers.
+ *
+ * @param index Entry in MODBUS_DEVICES
+ * @param sample Sample set holding the device's fresh readings
+ * @param settings Configured poll intervals
+ */
+void adaptPollInterval(int index, const SensorSample &sample, const AcquisitionSettings &settings)
+{
+    const ModbusDeviceLayout &layout = MODBUS_LAYOUT.devices[index];
+    ModbusDeviceState &state = modbusDeviceStates[index];
+
+    bool significant = false;
+    for (int i = layout.firstChannel; i < layout.firstChannel + layout.channels; i++)
+    {
+        const SensorReading &reading = sample.readings[i];
+        SensorReading &reference = pollReference[i];
+
+        if (reading.quality != reference.quality ||
+            abs(reading.centi - reference.centi) >= ADAPTIVE_DEADBAND)
+        {
+            reference = reading;
+            significant = true;
+        }
+    }
+
+    uint32_t configured = settings.pollIntervals[index];
+    if (significant || !ADAPTIVE_POLLING)
+    {
+        state.interval = configured;
+    }
+    else
+    {
+        state.interval = min(state.interval * 2, max((uint32_t)ADAPTIVE_MAX_INTERVAL, configured));
+    }
+}
+
+/**
+ * @brief Acquisition timer callback
+ *
+ * Runs in the esp_timer task when the next device is due and wakes
+ * the acquisition task.
+ *
+ * @param arg Unused
+ */
+void onAcquisitionTimer(void *arg)
+{
+    xTaskNotifyGive(acquisitionTaskHandle);
+}
+
+/**
+ * @brief Publish the fault counters of all devices and channels
+ *
+ * Called by the acquisition task after every device cycle.
+ */
+void publishBusHealth()
+{
+    BusHealth health;
+    for (int i = 0; i < (int)NUM_MODBUS_DEVICES; i++)
+    {
+        health.devices[i] = modbusDeviceStates[i].link.health.stats();
+        health.blockRead[i] = modbusDeviceStates[i].link.blockRead;
+    }
+    for (int i = 0; i < NUM_SENSORS; i++)
+    {
+        health.channels[i] = channelHealth[i].stats();
+    }
+    busHealth.publish(health);
+}
+
+/**
+ * @brief Acquisition task main function (bus scheduler)
+ *
+ * Reads every due device in priority order without pausing between
+ * transactions, then sleeps until the next device is due. After each
+ * device the updated sample set is published as the new sensorReadings
+ * snapshot together with the pre-serialized JSON payload. Publishing
+ * never blocks, regardless of how many readers are active.
+ *
+ * A device that fell behind (bus saturated) skips the missed intervals
+ * instead of queueing them. Stable devices back off (see
+ * adaptPollInterval()), leaving the bus to the channels that move, and
+ * failing devices back off further (see LinkHealth), leaving it to the
+ * devices that answer.
+ *
+ * @param arg Unused
+ */
+void acquisitionTask(void *arg)
+{
+    SensorSample sample;
+    sensorReadings.read(sample);
+
+    // Search the bus speed before the first poll (may take many timeouts)
+    if (MODBUS_BAUD_AUTO_PROBE)
+    {
+        if (modbusSleepLock != nullptr)
+        {
+            esp_pm_lock_acquire(modbusSleepLock);
+            esp_pm_lock_acquire(modbusApbLock);
+        }
+        probeModbusBaudRate();
+        baudProbeRunning = false;
+        if (modbusSleepLock != nullptr)
+        {
+            esp_pm_lock_release(modbusApbLock);
+            esp_pm_lock_release(modbusSleepLock);
+        }
+    }
+
+    for (;;)
+    {
+        int64_t now = esp_timer_get_time();
+        int64_t wait;
+        int index = selectDueDevice(now, wait);
+
+        if (index < 0)
+        {
+            esp_timer_start_once(acquisitionTimer, wait);
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        // Keep clocks up and sleep off while the UART is busy
+        if (modbusSleepLock != nullptr)
+        {
+            esp_pm_lock_acquire(modbusSleepLock);
+            esp_pm_lock_acquire(modbusApbLock);
+        }
+
+        AcquisitionSettings settings;
+        acquisitionSettings.read(settings);
+        if (settings.baudRate != modbusBaudRate)
+        {
+            setModbusBaudRate(settings.baudRate);
+        }
+
+        acquireDeviceData(index, sample, settings);
+
+        if (modbusSleepLock != nullptr)
+        {
+            esp_pm_lock_release(modbusApbLock);
+            esp_pm_lock_release(modbusSleepLock);
+        }
+
+        sensorReadings.publish(sample);
+        updateSensorDataCache(sample);
+        updateSensorStatistics(sample.timestamp);
+        publishBusHealth();
+        wakeMainLoop();
+
+        // Schedule the next read on the device's (adaptive) time grid,
+        // a failed device waits for its backoff or probe interval instead
+        adaptPollInterval(index, sample, settings);
+        ModbusDeviceState &state = modbusDeviceStates[index];
+        if (state.link.health.state() != LINK_OK)
+        {
+            state.nextPoll = now + state.link.retryWait * 1000LL;
+            continue;
+        }
+        int64_t period = state.interval * 1000LL;
+        state.nextPoll += period;
+        if (state.nextPoll <= now)
+        {
+            state.nextPoll = now + period;
+        }
+    }
+}
+
+/**
+ * @brief Start the Modbus acquisition task
+ *
+ * Publishes an initial all-error sample set, prepares the scheduler
+ * state of all devices (all due immediately), then creates the timer
+ * and the acquisition task pinned to ACQUISITION_TASK_CORE.
+ */
+void initAcquisition()
+{
+    Serial.println("Starting acquisition task...");
+
+    // Initialize all readings as "no data"
+    SensorSample initial;
+    memset(&initial, 0, sizeof(initial));
+    initial.timestamp = millis();
+    sensorReadings.publish(initial);
+    updateSensorDataCache(initial);
+    publishBusHealth();
+
+    for (int i = 0; i < NUM_SENSORS; i++)
+    {
+        rawValues[i] = SENSOR_BINARY_NO_VALUE;
+        for (int w = 0; w < NUM_STATISTICS_WINDOWS; w++)
+        {
+            sensorAggregates[i][w].begin(STATISTICS_WINDOWS[w]);
+        }
+    }
+    updateSensorStatistics(initial.timestamp);
+
+    AcquisitionSettings settings;
+    acquisitionSettings.read(settings);
+
+    // Read every device right away
+    int64_t now = esp_timer_get_time();
+    for (int i = 0; i < (int)NUM_MODBUS_DEVICES; i++)
+    {
+        modbusDeviceStates[i].nextPoll = now;
+        modbusDeviceStates[i].interval = settings.pollIntervals[i];
+        modbusDeviceStates[i].link.blockRead = MODBUS_BLOCK_READ;
+    }
+
+    const esp_timer_create_args_t timerArgs = {
+        .callback = onAcquisitionTimer,
+        .arg = nullptr,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "acquisition",
+        .skip_unhandled_events = true,
+    };
+    esp_timer_create(&timerArgs, &acquisitionTimer);
+
+    xTaskCreatePinnedToCore(acquisitionTask, "acquisition", ACQUISITION_TASK_STACK_SIZE,
+                            nullptr, ACQUISITION_TASK_PRIORITY, &acquisitionTaskHandle,
+                            ACQUISITION_TASK_CORE);
+
+    Serial.println("Acquisition task started");
+}
+
+/**
+ * @brief Take over the latest sensor snapshots for the LCD
+ *
+ * Non-blocking: copies the current readings, names and alarm state into
+ * the loop-local display buffers when a new version was published and
+ * requests a redraw. Called from loop().
+ */
+void updateSensorData()
+{
+    if (sensorReadings.version() != displayReadingsVersion)
+    {
+        displayReadingsVersion = sensorReadings.read(displaySample);
+        displayDirty = true;
+    }
+
+    if (sensorNameTable.version() != displayNamesVersion)
+    {
+        displayNamesVersion = sensorNameTable.read(displayNames);
+        displayDirty = true;
+    }
+
+    if (alarmStatus.version() != displayAlarmsVersion)
+    {
+        uint32_t previous = displayAlarms.active;
+        displayAlarmsVersion = alarmStatus.read(displayAlarms);
+        displayDirty = true;
+
+        // A new alarm switches the backlight on; without alarms the banner row is gone
+        if ((displayAlarms.active & ~previous) && LCD_BACKLIGHT_TIMEOUT != 0)
+        {
+            lastUserActivity = millis();
+            if (!backlightOn)
+            {
+                backlightOn = true;
+                lcd.backlight();
+            }
+        }
+        if (displayAlarms.active == 0 && displayOffset > MAX_DISPLAY_OFFSET)
+        {
+            displayOffset = MAX_DISPLAY_OFFSET;
+        }
+    }
+}
+
+// ============================================================================
+// NON-VOLATILE STORAGE FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Initialize preferences (non-volatile storage) and load the configuration
+ *
+ * Opens the "thermohub8" namespace in ESP32 flash memory and loads the
+ * configuration blob. Without a valid blob (first boot, older firmware,
+ * changed NUM_SENSORS) names are taken from the per-sensor keys of
+ * earlier versions or set to defaults, offsets are zero, poll
+ * intervals come from MODBUS_DEVICES, filters use the
+ * FILTER_DEFAULT_* values and the bus speed is MODBUS_BAUDRATE. Older
+ * layouts keep everything they have; the fields added later get their
+ * defaults.
+ */
+void initPreferences()
+{
+    Serial.println("Initializing Preferences...");
+    preferences.begin("thermohub8", false); // false = read/write mode
+
+    StoredConfig config;
+    const size_t sizeV1 = offsetof(StoredConfig, settings.filters);
+    const size_t sizeV2 = offsetof(StoredConfig, settings.baudRate);
+    size_t stored = preferences.getBytesLength("config");
+    uint32_t magic = (stored == sizeof(config)) ? CONFIG_MAGIC : (stored == sizeV2) ? CONFIG_MAGIC_V2 : CONFIG_MAGIC_V1;
+    bool loaded = (stored == sizeof(config) || stored == sizeV2 || stored == sizeV1) &&
+                  preferences.getBytes("config", &config, stored) == stored && config.magic == magic;
+
+    if (!loaded)
+    {
+        memset(&config, 0, sizeof(config));
+
+        // Load or create default sensor names
+        for (int i = 0; i < NUM_SENSORS; i++)
+        {
+            char key[16];
+            snprintf(key, sizeof(key), "sensor%d", i);
+            String name = preferences.getString(key, SENSOR_CHANNELS[i].label);
+            strlcpy(config.names.names[i], name.c_str(), sizeof(config.names.names[i]));
+        }
+
+        for (int i = 0; i < (int)NUM_MODBUS_DEVICES; i++)
+        {
+            config.settings.pollIntervals[i] = MODBUS_DEVICES[i].pollInterval;
+        }
+
+        Serial.println("No stored configuration, using defaults");
+    }
+
+    for (int i = 0; i < NUM_SENSORS; i++)
+    {
+        // Blob content is not trusted to be terminated
+        config.names.names[i][MAX_SENSOR_NAME_LENGTH] = '\0';
+
+        // Layout 1 has no filters, and the blob is not trusted to hold valid ones
+        if (stored == sizeV1 || !isValidFilterConfig(config.settings.filters[i]))
+        {
+            config.settings.filters[i] = {FILTER_DEFAULT_MEDIAN, FILTER_DEFAULT_SMOOTHING};
+        }
+
+        Serial.print("Sensor ");
+        Serial.print(i);
+        Serial.print(": ");
+        Serial.println(config.names.names[i]);
+    }
+
+    // Layouts 1 and 2 have no baud rate
+    if (stored != sizeof(config) || !isValidModbusBaudRate(config.settings.baudRate))
+    {
+        config.settings.baudRate = MODBUS_BAUDRATE;
+    }
+
+    sensorNameTable.publish(config.names);
+    acquisitionSettings.publish(config.settings);
+}
+
+/**
+ * @brief Request a configuration flash write
+ *
+ * Called by the web handlers after publishing a changed name table or
+ * settings. The write itself happens in loop() once no further change
+ * arrived for CONFIG_COMMIT_DELAY, so a burst of edits costs a single
+ * flash write and the AsyncTCP task never waits for NVS.
+ */
+void scheduleConfigCommit()
+{
+    configChangeTime = millis();
+    configDirty = true;
+    wakeMainLoop();
+}
+
+/**
+ * @brief Write the configuration blob if a change is pending and settled
+ *
+ * Called from loop().
+ *
+ * @param force Write a pending change right away (before a restart)
+ */
+void commitConfig(bool force = false)
+{
+    if (!configDirty || (!force && millis() - configChangeTime < CONFIG_COMMIT_DELAY))
+    {
+        return;
+    }
+    configDirty = false;
+
+    StoredConfig config;
+    config.magic = CONFIG_MAGIC;
+    sensorNameTable.read(config.names);
+    acquisitionSettings.read(config.settings);
+
+    if (preferences.putBytes("config", &config, sizeof(config)) == sizeof(config))
+    {
+        Serial.println("Configuration saved");
+    }
+    else
+    {
+        Serial.println("Configuration could not be saved");
+    }
+}
+
+/**
+ * @brief Change a sensor name
+ *
+ * Publishes the updated name table right away; the flash write is
+ * deferred (scheduleConfigCommit()).
+ * Called from the AsyncTCP task only (single snapshot writer).
+ *
+ * @param sensorIndex Index of the sensor (0 to NUM_SENSORS-1)
+ * @param name New name for the sensor (truncated to MAX_SENSOR_NAME_LENGTH chars)
+ */
+void saveSensorName(int sensorIndex, const char *name)
+{
+    // Validate sensor index
+    if (sensorIndex >= 0 && sensorIndex < NUM_SENSORS)
+    {
+        SensorNameTable table;
+        sensorNameTable.read(table);
+        strlcpy(table.names[sensorIndex], name, sizeof(table.names[sensorIndex]));
+        sensorNameTable.publish(table);
+        scheduleConfigCommit();
+
+        Serial.print("Sensor name saved: ");
+        Serial.print(sensorIndex);
+        Serial.print(" = ");
+        Serial.println(table.names[sensorIndex]);
+    }
+}
+
+// ============================================================================
+// LCD DISPLAY FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Initialize the LCD display
+ *
+ * Sets up I2C communication, initializes the LCD and displays a welcome
+ * message.
+ */
+void initDisplay()
+{
+    Serial.println("Initializing LCD...");
+
+    // Initialize I2C bus
+    Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN);
+
+    // Initialize LCD display
+    lcd.init();
+    lcd.backlight();
+    lcd.clear();
+
+    // Display welcome message
+    lcd.setCursor(1, 0);
+    lcd.print("Thermohub8");
+    lcd.setCursor(-4, 2); // Using offset workaround for row 2
+    lcd.print("Developed by");
+    lcd.setCursor(-4, 3); // Using offset workaround for row 3
+    lcd.print("Johannes    v1.0");
+
+    // The splash stays until refreshDisplay() draws the first readings;
+    // startup continues right away
+    lcdFrame.begin();
+
+    Serial.println("LCD initialized");
+}
+
+/**
+ * @brief Print sensor data to LCD at current cursor position
+ *
+ * Displays sensor name (truncated to DISPLAY_NAME_LENGTH) followed by
+ * temperature value with one decimal place and °C symbol.
+ *
+ * Format: "SensName  XX.X°C", a stale value is marked with '*'
+ * instead of the separator: "SensName* XX.X°C"
+ *
+ * @param sensorIndex Index of the sensor to display
+ */
+void print_sensordata(int sensorIndex)
+{
+    // Get and truncate sensor name if needed
+    const char *displayName = displayNames.names[sensorIndex];
+    size_t nameLength = strnlen(displayName, DISPLAY_NAME_LENGTH);
+    for (size_t i = 0; i < nameLength; i++)
+    {
+        lcdFrame.write(displayName[i]);
+    }
+
+    // Pad name with spaces to align temperature (right-aligned)
+    for (int i = nameLength; i < DISPLAY_NAME_LENGTH; i++)
+    {
+        lcdFrame.print(" ");
+    }
+    const SensorReading &reading = displaySample.readings[sensorIndex];
+    lcdFrame.print((reading.quality & QUALITY_STALE) ? "*" : " ");
+
+    // Display temperature value
+    if (hasValue(reading))
+    {
+        // Right-align the value in 5 characters ("-12.3", "  5.0", "105.7")
+        char text[8];
+        size_t length = formatDeci(toDeci(reading.centi), text);
+        for (size_t i = length; i < 5; i++)
+            lcdFrame.print(" ");
+
+        lcdFrame.print(text);
+        lcdFrame.print((char)223); // Degree symbol '°'
+        lcdFrame.print("C");
+    }
+    else
+    {
+        // Display error indicator
+        lcdFrame.print(" --.-");
+        lcdFrame.print((char)223);
+        lcdFrame.print("C");
+    }
+}
+
+/**
+ * @brief Print menu/info items on LCD
+ *
+ * Displays system information after the sensor list:
+ * - Separator line
+ * - IP address label
+ * - IP address value
+ * - Version information
+ *
+ * @param sensorIndex Current item index (sensor count + menu offset)
+ * @param row Current LCD row (0-3)
+ */
+void print_menu(int sensorIndex, int row)
+{
+    switch (sensorIndex - NUM_SENSORS)
+    {
+    case MENU_SEPARATOR:
+        // Separator line after sensors
+        lcdFrame.setCursor(0, row);
+        lcdFrame.print("================");
+        break;
+    case MENU_IP_LABEL:
+        // IP address label
+        lcdFrame.setCursor(0, row);
+        lcdFrame.print("IP-Address:");
+        break;
+    case MENU_IP_VALUE:
+        // IP address value (0.0.0.0 until WiFi is connected)
+        lcdFrame.setCursor(0, row);
+        if ((uint32_t)WiFi.localIP() == 0)
+        {
+            lcdFrame.print("Connecting...");
+        }
+        else
+        {
+            lcdFrame.print(WiFi.localIP());
+        }
+        break;
+    case MENU_VERSION:
+        // Version information
+        lcdFrame.setCursor(0, row);
+        lcdFrame.print("Version:     " FIRMWARE_VERSION);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Print the alarm banner on LCD at current cursor position
+ *
+ * Format: "!Overheat     +1" - label of the first active rule, followed
+ * by the number of further active rules.
+ */
+void print_alarm_banner()
+{
+    uint32_t active = displayAlarms.active;
+    lcdFrame.print("!");
+    lcdFrame.print(ALARM_RULES[__builtin_ctz(active)].label);
+
+    int more = __builtin_popcount(active) - 1;
+    if (more > 0)
+    {
+        char text[4];
+        int length = snprintf(text, sizeof(text), "+%d", more);
+        lcdFrame.setCursor(LCD_COLS - length, 0);
+        lcdFrame.print(text);
+    }
+}
+
+/**
+ * @brief Update LCD display with current data
+ *
+ * Renders 4 rows of information starting from the current scroll position
+ * into the framebuffer and sends only the changed characters to the LCD.
+ * Displays either sensor data or menu items depending on scroll offset.
+ * While an alarm is active, row 0 shows the alarm banner and the list
+ * starts in row 1.
+ *
+ * Note: The X-axis correction for rows 3-4 (LCD library bug) is applied
+ * by the framebuffer when writing to the display.
+ */
+void updateDisplay()
+{
+    ScopedLatency latency(metrics.displayUpdate);
+
+    lcdFrame.clear();
+
+    int firstRow = 0;
+    if (displayAlarms.active != 0)
+    {
+        lcdFrame.setCursor(0, 0);
+        print_alarm_banner();
+        firstRow = 1;
+    }
+
+    // Display the remaining rows starting from displayOffset
+    for (int row = firstRow; row < LCD_ROWS; row++)
+    {
+        int sensorIndex = displayOffset + row - firstRow;
+
+        // Display sensor data if within sensor range
+        if (sensorIndex < NUM_SENSORS)
+        {
+            lcdFrame.setCursor(0, row);
+            print_sensordata(sensorIndex);
+        }
+
+        // Display menu items after sensors
+        print_menu(sensorIndex, row);
+    }
+
+    lcdFrame.flush();
+}
+
+/**
+ * @brief Redraw the LCD if anything visible changed
+ *
+ * Called from loop(). Redraws happen only after new sensor data, a
+ * scroll event or an IP address change instead of on every pass.
+ */
+void refreshDisplay()
+{
+    if (splashVisible)
+    {
+        // Only the placeholder sample from initAcquisition() so far
+        if (displayReadingsVersion <= 1)
+        {
+            return;
+        }
+        splashVisible = false;
+        lcdFrame.invalidate(); // Overwrite every cell of the splash
+    }
+
+    uint32_t ip = WiFi.localIP();
+    if (ip != displayedIP)
+    {
+        displayedIP = ip;
+        displayDirty = true;
+    }
+
+    if (displayDirty)
+    {
+        displayDirty = false;
+        updateDisplay();
+    }
+}
+
+/**
+ * @brief Scroll display up by one row
+ *
+ * Decrements the display offset if not already at the top,
+ * then refreshes the display.
+ */
+void scrollUp()
+{
+    if (displayOffset > 0)
+    {
+        displayOffset--;
+        updateDisplay();
+    }
+}
+
+/**
+ * @brief Scroll display down by one row
+ *
+ * Increments the display offset if not already at the bottom,
+ * then refreshes the display. The last menu item ends up in the last row.
+ */
+void scrollDown()
+{
+    if (displayOffset < (displayAlarms.active != 0 ? MAX_DISPLAY_OFFSET_ALARM : MAX_DISPLAY_OFFSET))
+    {
+        displayOffset++;
+        updateDisplay();
+    }
+}
+
+// ============================================================================
+// POWER MANAGEMENT FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Configure frequency scaling, light sleep and WiFi modem sleep
+ *
+ * Depending on POWER_MODE the CPU clock drops to POWER_MIN_CPU_FREQ
+ * whenever all tasks are blocked, and in POWER_MODE_LOW_POWER the chip
+ * enters light sleep between acquisition cycles. Wake-up sources:
+ * esp_timer (acquisition, joystick sampling), the joystick button GPIO
+ * and the WiFi modem (incoming TCP at the next DTIM beacon).
+ *
+ * Modbus transactions hold PM locks so the UART neither loses bytes to
+ * light sleep nor changes its clock mid-frame.
+ */
+void initPowerManagement()
+{
+    if (POWER_MODE == POWER_MODE_PERFORMANCE)
+    {
+        return;
+    }
+
+    Serial.println("Initializing Power Management...");
+
+    esp_pm_config_t config = {
+        .max_freq_mhz = POWER_MAX_CPU_FREQ,
+        .min_freq_mhz = POWER_MIN_CPU_FREQ,
+        .light_sleep_enable = (POWER_MODE == POWER_MODE_LOW_POWER),
+    };
+
+    esp_err_t result = esp_pm_configure(&config);
+    if (result != ESP_OK && config.light_sleep_enable)
+    {
+        // Core built without tickless idle: keep frequency scaling only
+        Serial.println("Light sleep not supported, using frequency scaling only");
+        config.light_sleep_enable = false;
+        result = esp_pm_configure(&config);
+    }
+
+    if (result != ESP_OK)
+    {
+        Serial.print("Power management not available: ");
+        Serial.println(esp_err_to_name(result));
+        return;
+    }
+
+    esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "modbus", &modbusSleepLock);
+    esp_pm_lock_create(ESP_PM_APB_FREQ_MAX, 0, "modbus", &modbusApbLock);
+
+    if (config.light_sleep_enable)
+    {
+        // Joystick button (active low) wakes the chip from light sleep
+        gpio_wakeup_enable((gpio_num_t)JOY_SW_PIN, GPIO_INTR_LOW_LEVEL);
+        esp_sleep_enable_gpio_wakeup();
+    }
+
+    // Modem sleep: radio sleeps between DTIM beacons
+    WiFi.setSleep(POWER_MODE == POWER_MODE_LOW_POWER ? WIFI_PS_MAX_MODEM : WIFI_PS_MIN_MODEM);
+
+    Serial.println(config.light_sleep_enable ? "Power management: light sleep" : "Power management: frequency scaling");
+}
+
+/**
+ * @brief Register user activity and switch the backlight back on
+ *
+ * Called by the joystick callbacks. The first input after the backlight
+ * went off only wakes the display and is not treated as navigation.
+ *
+ * @return true if the backlight was off (input consumed)
+ */
+bool wakeBacklight()
+{
+    lastUserActivity = millis();
+
+    if (backlightOn)
+    {
+        return false;
+    }
+
+    backlightOn = true;
+    lcd.backlight();
+    return true;
+}
+
+/**
+ * @brief Switch the backlight off after LCD_BACKLIGHT_TIMEOUT without input
+ *
+ * Called from loop().
+ */
+void updateBacklight()
+{
+    // Compiled out with a timeout of 0 (the comparison would always be true)
+#if LCD_BACKLIGHT_TIMEOUT > 0
+    if (backlightOn && millis() - lastUserActivity >= LCD_BACKLIGHT_TIMEOUT)
+    {
+        backlightOn = false;
+        lcd.noBacklight();
+    }
+#endif
+}
+
+// ============================================================================
+// JOYSTICK CALLBACK FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Callback for joystick up movement
+ * Scrolls the display up by one row
+ */
+void onJoystickUp()
+{
+    Serial.println("Joystick: Up");
+    if (!wakeBacklight())
+    {
+        scrollUp();
+    }
+}
+
+/**
+ * @brief Callback for joystick down movement
+ * Scrolls the display down by one row
+ */
+void onJoystickDown()
+{
+    Serial.println("Joystick: Down");
+    if (!wakeBacklight())
+    {
+        scrollDown();
+    }
+}
+
+/**
+ * @brief Callback for joystick left movement
+ * Currently unused - reserved for future features
+ */
+void onJoystickLeft()
+{
+    Serial.println("Joystick: Left");
+}
+
+/**
+ * @brief Callback for joystick right movement
+ * Currently unused - reserved for future features
+ */
+void onJoystickRight()
+{
+    Serial.println("Joystick: Right");
+}
+
+/**
+ * @brief Callback for joystick center position
+ * Currently unused - reserved for future features
+ */
+void onJoystickCenter()
+{
+    Serial.println("Joystick: Center");
+}
+
+/**
+ * @brief Callback for joystick button press
+ * Currently unused - reserved for future menu navigation
+ */
+void onJoystickSwitch()
+{
+    Serial.println("Joystick: Switch pressed");
+    wakeBacklight();
+    // Reserved for menu system implementation
+}
+
+/**
+ * @brief Initialize joystick controller
+ *
+ * Configures the joystick with calibration values, axis inversion,
+ * and registers all callback functions for user interaction.
+ */
+void initJoystick()
+{
+    Serial.println("Initializing Joystick...");
+
+    joystick.begin();
+    joystick.setThresholds(JOY_MIN_VAL, JOY_MAX_VAL, JOY_CENTER_VAL, JOY_DEADZONE);
+
+    // Invert Y-axis for intuitive up/down navigation
+    // Uncomment to invert X-axis if needed
+    // joystick.setInvertX(true);
+    joystick.setInvertY(true);
+
+    // Enable debug mode for troubleshooting (outputs to serial)
+    // Uncomment to see raw joystick values and events
+    // joystick.setDebugMode(true);
+
+    // Register callback functions for joystick events
+    joystick.onUp(onJoystickUp);
+    joystick.onDown(onJoystickDown);
+
+    // These callbacks are currently unused but available for future features
+    joystick.onLeft(onJoystickLeft);
+    joystick.onRight(onJoystickRight);
+    joystick.onCenter(onJoystickCenter);
+    joystick.onSwitch(onJoystickSwitch);
+
+    // Event mode: interrupts and timer queue events, loop() dispatches them
+    if (JOY_EVENT_MODE)
+    {
+        joystick.setNotifyTask(mainLoopTaskHandle);
+        joystickEventMode = joystick.beginEventMode(JOY_SAMPLE_INTERVAL, JOY_HYSTERESIS);
+        if (!joystickEventMode)
+        {
+            Serial.println("Joystick event mode failed, polling instead");
+        }
+    }
+
+    Serial.println("Joystick initialized");
+}
+
+// ============================================================================
+// WIFI FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief WiFi event handler
+ *
+ * Runs in the WiFi event task. Starts the web server as soon as the
+ * first IP address is assigned; after a reconnect the server keeps
+ * running and simply becomes reachable again.
+ *
+ * @param event Event ID
+ * @param info Event details
+ */
+void onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info)
+{
+    switch (event)
+    {
+    case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+        Serial.print("WiFi connected, IP: ");
+        Serial.println(WiFi.localIP());
+
+        if (!webServerStarted)
+        {
+            server.begin();
+            webServerStarted = true;
+            Serial.println("Web Server started");
+
+            // Wall clock for the flash log, SNTP keeps it synchronized from here on
+            configTime(0, 0, NTP_SERVER);
+
+            // The MQTT client reconnects on its own from here on
+            if (mqttTaskHandle != nullptr)
+            {
+                mqtt.start();
+            }
+        }
+        wakeMainLoop(); // Show the new IP in the info menu
+        break;
+
+    case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+        Serial.print("WiFi disconnected, reason ");
+        Serial.println(info.wifi_sta_disconnected.reason);
+        wakeMainLoop();
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Start connecting to WiFi in the background
+ *
+ * Returns immediately. The connection result arrives via onWiFiEvent(),
+ * the LCD info menu shows the IP address once it is assigned.
+ */
+void initWiFi()
+{
+    Serial.println("Connecting WiFi...");
+
+    WiFi.onEvent(onWiFiEvent);
+    WiFi.setHostname(HOSTNAME);
+    WiFi.setAutoReconnect(true);
+    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+}
+
+/**
+ * @brief Retry the WiFi connection while disconnected
+ *
+ * Called from loop(). Complements the automatic reconnect of the WiFi
+ * driver, which gives up for some disconnect reasons (e.g. access
+ * point not found after a power failure).
+ */
+void maintainWiFi()
+{
+    if (WiFi.status() == WL_CONNECTED)
+    {
+        lastWiFiReconnect = millis();
+        return;
+    }
+
+    if (millis() - lastWiFiReconnect >= WIFI_RECONNECT_INTERVAL)
+    {
+        lastWiFiReconnect = millis();
+        Serial.println("WiFi reconnecting...");
+        WiFi.reconnect();
+    }
+}
+
+// ============================================================================
+// HISTORY FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Reserve the history memory
+ *
+ * Uses HISTORY_PSRAM_SIZE of PSRAM if available, otherwise
+ * HISTORY_MEMORY_SIZE of internal RAM.
+ */
+void initHistory()
+{
+    Serial.println("Initializing History...");
+
+    size_t size = psramFound() ? HISTORY_PSRAM_SIZE : HISTORY_MEMORY_SIZE;
+    if (history.begin(NUM_SENSORS, size, true))
+    {
+        Serial.print("History: ");
+        Serial.print((unsigned long)history.capacityRows());
+        Serial.print(" rows (");
+        Serial.print((unsigned long)(history.capacityRows() * HISTORY_INTERVAL / 3600));
+        Serial.println(history.usesPsram() ? " h, PSRAM)" : " h)");
+    }
+    else
+    {
+        Serial.println("History: not enough memory");
+    }
+}
+
+/**
+ * @brief Convert a reading to history units (0.01 °C)
+ *
+ * Only current readings are recorded; stale values are not repeated.
+ *
+ * @param reading Channel reading
+ * @return int16_t Value in 0.01 °C, HISTORY_NO_VALUE if not read in the last cycle
+ */
+int16_t toHistoryValue(const SensorReading &reading)
+{
+    return (reading.quality & QUALITY_OK) ? reading.centi : HISTORY_NO_VALUE;
+}
+
+/**
+ * @brief Append the latest readings to the history
+ *
+ * Called from loop(), records one row every HISTORY_INTERVAL seconds.
+ * Timestamps are seconds since boot.
+ */
+void updateHistory()
+{
+    unsigned long currentTime = millis();
+
+    // Check if history interval has elapsed
+    if (currentTime - lastHistoryUpdate >= HISTORY_INTERVAL * 1000UL)
+    {
+        lastHistoryUpdate = currentTime;
+
+        SensorSample sample;
+        sensorReadings.read(sample);
+
+        int16_t values[NUM_SENSORS];
+        for (int i = 0; i < NUM_SENSORS; i++)
+        {
+            values[i] = toHistoryValue(sample.readings[i]);
+        }
+        history.append(currentTime / 1000, values);
+    }
+}
+
+// State of one streamed /api/v1/history response
+struct HistoryStream
+{
+    enum Phase
     {
-        // Display error indicator
-        lcd.print(" --.-");
-        lcd.print((char)223);
-        lcd.print("C");
+        HEADER,
+        ROWS,
+        FOOTER,
+        DONE
+    };
+
+    uint32_t from;                // Requested range in seconds since boot
+    uint32_t to;
+    uint32_t step;                // Bucket width in seconds
+    Phase phase;
+    SensorHistory::Cursor cursor; // Read position in the history
+
+    // Bucket being aggregated
+    bool bucketOpen;
+    uint32_t bucketStart;
+    int32_t sum[NUM_SENSORS];
+    uint16_t count[NUM_SENSORS];
+    bool firstRow;
+
+    // Formatted text not yet copied into a response chunk
+    char pending[32 + NUM_SENSORS * 10];
+    size_t pendingLength;
+    size_t pendingPosition;
+};
+
+/**
+ * @brief Format the current bucket as one JSON row
+ *
+ * Row format: [time,value,...] with values as mean in °C (2 decimals)
+ * or null if the sensor had no reading within the bucket.
+ */
+void formatHistoryBucket(HistoryStream &stream)
+{
+    char *out = stream.pending;
+    size_t room = sizeof(stream.pending);
+    int n = snprintf(out, room, "%s[%lu", stream.firstRow ? "" : ",", (unsigned long)stream.bucketStart);
+
+    for (int i = 0; i < NUM_SENSORS && n < (int)room; i++)
+    {
+        if (stream.count[i] == 0)
+        {
+            n += snprintf(out + n, room - n, ",null");
+            continue;
+        }
+        int32_t mean = lroundf((float)stream.sum[i] / stream.count[i]);
+        uint32_t magnitude = abs(mean);
+        n += snprintf(out + n, room - n, ",%s%lu.%02lu", mean < 0 ? "-" : "",
+                      (unsigned long)(magnitude / 100), (unsigned long)(magnitude % 100));
+    }
+    if (n < (int)room)
+    {
+        n += snprintf(out + n, room - n, "]");
     }
+
+    stream.pendingLength = min((size_t)n, room - 1);
+    stream.pendingPosition = 0;
+    stream.firstRow = false;
+    stream.bucketOpen = false;
 }
 
 /**
- * @brief Print menu/info items on LCD
+ * @brief Produce the next piece of the history document
  *
- * Displays system information after the sensor list:
- * - Separator line
- * - IP address label
- * - IP address value
- * - Version information
+ * Reads rows from the history until one downsampled bucket is complete
+ * and formats it into the pending buffer. Holds the history lock only
+ * while decoding, never while the network sends data.
+ *
+ * @param stream Response state
+ */
+void produceHistoryText(HistoryStream &stream)
+{
+    switch (stream.phase)
+    {
+    case HistoryStream::HEADER:
+        stream.pendingLength = snprintf(stream.pending, sizeof(stream.pending),
+                                        "{\"now\":%lu,\"interval\":%d,\"step\":%lu,\"rows\":[",
+                                        millis() / 1000, HISTORY_INTERVAL, (unsigned long)stream.step);
+        stream.pendingPosition = 0;
+
+        history.lock();
+        history.seek(stream.cursor, stream.from);
+        history.unlock();
+
+        stream.phase = HistoryStream::ROWS;
+        return;
+
+    case HistoryStream::ROWS:
+    {
+        uint32_t time;
+        int16_t values[NUM_SENSORS];
+        bool formatted = false;
+
+        history.lock();
+        while (!formatted)
+        {
+            if (!history.next(stream.cursor, time, values) || time > stream.to)
+            {
+                // End of range: emit the last bucket
+                if (stream.bucketOpen)
+                {
+                    formatHistoryBucket(stream);
+                }
+                stream.phase = HistoryStream::FOOTER;
+                break;
+            }
+            if (time < stream.from)
+            {
+                continue;
+            }
+
+            uint32_t bucketStart = stream.from + (time - stream.from) / stream.step * stream.step;
+            if (stream.bucketOpen && bucketStart != stream.bucketStart)
+            {
+                formatHistoryBucket(stream);
+                formatted = true;
+            }
+
+            if (!stream.bucketOpen)
+            {
+                stream.bucketOpen = true;
+                stream.bucketStart = bucketStart;
+                memset(stream.sum, 0, sizeof(stream.sum));
+                memset(stream.count, 0, sizeof(stream.count));
+            }
+
+            for (int i = 0; i < NUM_SENSORS; i++)
+            {
+                if (values[i] != HISTORY_NO_VALUE)
+                {
+                    stream.sum[i] += values[i];
+                    stream.count[i]++;
+                }
+            }
+        }
+        history.unlock();
+        return;
+    }
+
+    case HistoryStream::FOOTER:
+        stream.pendingLength = snprintf(stream.pending, sizeof(stream.pending), "]}");
+        stream.pendingPosition = 0;
+        stream.phase = HistoryStream::DONE;
+        return;
+
+    case HistoryStream::DONE:
+        return;
+    }
+}
+
+/**
+ * @brief Stream downsampled history as a chunked JSON response
+ *
+ * Query parameters (all optional, seconds since boot):
+ * - from: start of range (default: oldest row)
+ * - to:   end of range (default: now)
+ * - step: bucket width, values are averaged per bucket (default: HISTORY_INTERVAL)
+ *
+ * Returns: {"now":3600,"interval":10,"step":60,"rows":[[0,21.50,null,...],...]}
+ * Rows are decoded bucket by bucket while the response is sent; the
+ * requested range is never materialized in memory.
+ *
+ * @param request Incoming HTTP request
+ */
+void sendHistory(AsyncWebServerRequest *request)
+{
+    std::shared_ptr<HistoryStream> stream = std::make_shared<HistoryStream>();
+    memset(stream.get(), 0, sizeof(HistoryStream));
+
+    stream->from = request->hasParam("from") ? request->getParam("from")->value().toInt() : 0;
+    stream->to = request->hasParam("to") ? request->getParam("to")->value().toInt() : UINT32_MAX;
+    stream->step = request->hasParam("step") ? request->getParam("step")->value().toInt() : HISTORY_INTERVAL;
+    stream->step = max(stream->step, (uint32_t)1);
+    stream->phase = HistoryStream::HEADER;
+    stream->firstRow = true;
+
+    AsyncWebServerResponse *response = request->beginChunkedResponse(
+        "application/json",
+        [stream](uint8_t *buffer, size_t maxLen, size_t index) -> size_t
+        {
+            size_t written = 0;
+            while (written < maxLen)
+            {
+                if (stream->pendingPosition < stream->pendingLength)
+                {
+                    size_t len = min(stream->pendingLength - stream->pendingPosition, maxLen - written);
+                    memcpy(buffer + written, stream->pending + stream->pendingPosition, len);
+                    stream->pendingPosition += len;
+                    written += len;
+                    continue;
+                }
+                if (stream->phase == HistoryStream::DONE)
+                {
+                    break;
+                }
+                stream->pendingLength = 0;
+                produceHistoryText(*stream);
+            }
+            return written;
+        });
+    request->send(response);
+}
+
+// ============================================================================
+// FLASH LOG FUNCTIONS
+// ============================================================================
+
+static_assert(FLASH_LOG_NO_VALUE == HISTORY_NO_VALUE, "Flash log and history share toHistoryValue()");
+
+/**
+ * @brief Mount LittleFS and start the flash log writer
+ *
+ * Formats the file system if it cannot be mounted (first boot). Without
+ * it the firmware runs as before, only /api/v1/log stays empty.
+ */
+void initFlashLog()
+{
+    Serial.println("Initializing Flash Log...");
+
+    if (!LittleFS.begin(true))
+    {
+        Serial.println("Flash Log: LittleFS not available");
+        return;
+    }
+
+    if (flashLog.begin(LittleFS, FLASH_LOG_DIRECTORY, NUM_SENSORS, FLASH_LOG_SEGMENT_SIZE, FLASH_LOG_SEGMENTS) &&
+        flashLog.startWriter(FLASH_LOG_BATCH_SIZE, FLASH_LOG_FLUSH_INTERVAL, FLASH_LOG_TASK_PRIORITY, FLASH_LOG_TASK_CORE))
+    {
+        Serial.print("Flash Log: ");
+        Serial.print((unsigned long)flashLog.storedRecords());
+        Serial.print(" of ");
+        Serial.print((unsigned long)flashLog.capacityRecords());
+        Serial.print(" records (");
+        Serial.print((unsigned long)(flashLog.capacityRecords() / (86400 / FLASH_LOG_INTERVAL)));
+        Serial.println(" days)");
+    }
+    else
+    {
+        Serial.println("Flash Log: initialization failed");
+    }
+}
+
+/**
+ * @brief Hand the latest readings to the flash log
+ *
+ * Called from loop(), queues one record every FLASH_LOG_INTERVAL
+ * seconds once the wall clock is set. Only copies into the writer's
+ * queue; flash access happens in the writer task.
+ */
+void updateFlashLog()
+{
+    unsigned long currentTime = millis();
+
+    if (currentTime - lastFlashLogUpdate < FLASH_LOG_INTERVAL * 1000UL)
+    {
+        return;
+    }
+
+    uint32_t now = wallClockTime();
+    if (now == 0)
+    {
+        return; // No SNTP time yet
+    }
+    lastFlashLogUpdate = currentTime;
+
+    SensorSample sample;
+    sensorReadings.read(sample);
+
+    int16_t values[NUM_SENSORS];
+    for (int i = 0; i < NUM_SENSORS; i++)
+    {
+        values[i] = toHistoryValue(sample.readings[i]);
+    }
+    flashLog.append(now, values);
+}
+
+/**
+ * @brief Stream the flash log as raw records
+ *
+ * Query parameters (Unix time in seconds, both optional):
+ * - from: first record of interest (default: oldest)
+ * - to:   last record of interest (default: newest)
+ *
+ * Returns the records unchanged as application/octet-stream; the
+ * layout is given in the X-Record-Size and X-Channels headers. Each
+ * response chunk is read from the segment file directly into the
+ * response buffer, segments outside the range are skipped via the
+ * index.
+ *
+ * @param request Incoming HTTP request
+ */
+void sendFlashLog(AsyncWebServerRequest *request)
+{
+    std::shared_ptr<FlashLog::Cursor> cursor = std::make_shared<FlashLog::Cursor>();
+
+    uint32_t from = request->hasParam("from") ? strtoul(request->getParam("from")->value().c_str(), nullptr, 10) : 0;
+    uint32_t to = request->hasParam("to") ? strtoul(request->getParam("to")->value().c_str(), nullptr, 10) : UINT32_MAX;
+    flashLog.seek(*cursor, from, to);
+
+    AsyncWebServerResponse *response = request->beginChunkedResponse(
+        "application/octet-stream",
+        [cursor](uint8_t *buffer, size_t maxLen, size_t index) -> size_t
+        { return flashLog.read(*cursor, buffer, maxLen); });
+    response->addHeader("X-Record-Size", String((unsigned long)flashLog.recordSize()));
+    response->addHeader("X-Channels", String(flashLog.channels()));
+    response->addHeader("Content-Disposition", "attachment; filename=\"thermohub8.log\"");
+    request->send(response);
+}
+
+// ============================================================================
+// MQTT FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Add the device block shared by all discovery configs
+ *
+ * @param doc Discovery config document
+ */
+void addMqttDevice(JsonDocument &doc)
+{
+    JsonObject device = doc.createNestedObject("device");
+    device.createNestedArray("identifiers").add(mqttDeviceId);
+    device["name"] = "ThermoHub8";
+    device["manufacturer"] = "ThermoHub";
+    device["model"] = "ThermoHub8";
+    device["sw_version"] = FIRMWARE_VERSION;
+}
+
+/**
+ * @brief Publish the Home Assistant discovery config of one sensor
+ *
+ * All sensors share the state topic; each picks its entry out of the
+ * sensordata JSON. The status ("ok", "stale", ...) becomes an attribute.
+ *
+ * @param sensor Sensor index
+ * @param name Current sensor name
+ * @return bool false if the message was not accepted (retry later)
+ */
+bool publishMqttDiscovery(int sensor, const char *name)
+{
+    char topic[96];
+    char uniqueId[32];
+    char valueTemplate[48];
+    char attributesTemplate[80];
+    snprintf(topic, sizeof(topic), "%s/sensor/%s/s%d/config", MQTT_DISCOVERY_PREFIX, mqttDeviceId, sensor);
+    snprintf(uniqueId, sizeof(uniqueId), "%s_s%d", mqttDeviceId, sensor);
+    snprintf(valueTemplate, sizeof(valueTemplate), "{{ value_json.sensors[%d].value }}", sensor);
+    snprintf(attributesTemplate, sizeof(attributesTemplate),
+             "{{ {'status': value_json.sensors[%d].status} | tojson }}", sensor);
+
+    StaticJsonDocument<MQTT_DISCOVERY_SIZE> doc;
+    doc["name"] = name;
+    doc["unique_id"] = uniqueId;
+    doc["state_topic"] = mqttStateTopic;
+    doc["value_template"] = valueTemplate;
+    doc["json_attributes_topic"] = mqttStateTopic;
+    doc["json_attributes_template"] = attributesTemplate;
+    doc["availability_topic"] = mqttStatusTopic;
+    doc["unit_of_measurement"] = "°C";
+    doc["device_class"] = "temperature";
+    doc["state_class"] = "measurement";
+    doc["suggested_display_precision"] = 1;
+    addMqttDevice(doc);
+
+    char payload[MQTT_DISCOVERY_SIZE];
+    size_t length = serializeJson(doc, payload, sizeof(payload));
+    return mqtt.publish(topic, payload, length, 1, true);
+}
+
+/**
+ * @brief Publish the Home Assistant discovery config of one alarm rule
+ *
+ * Each rule becomes a binary sensor reading its entry of the alarm
+ * topic; overheat and rising rules use device class "heat", frost and
+ * falling rules "cold".
+ *
+ * @param alarm Index in ALARM_RULES
+ * @return bool false if the message was not accepted (retry later)
+ */
+bool publishMqttAlarmDiscovery(int alarm)
+{
+    const AlarmRule &rule = ALARM_RULES[alarm];
+    char topic[96];
+    char uniqueId[32];
+    char valueTemplate[80];
+    snprintf(topic, sizeof(topic), "%s/binary_sensor/%s/a%d/config", MQTT_DISCOVERY_PREFIX, mqttDeviceId, alarm);
+    snprintf(uniqueId, sizeof(uniqueId), "%s_a%d", mqttDeviceId, alarm);
+    snprintf(valueTemplate, sizeof(valueTemplate),
+             "{{ 'ON' if value_json.alarms[%d].active else 'OFF' }}", alarm);
+
+    StaticJsonDocument<MQTT_DISCOVERY_SIZE> doc;
+    doc["name"] = rule.label;
+    doc["unique_id"] = uniqueId;
+    doc["state_topic"] = mqttAlarmTopic;
+    doc["value_template"] = valueTemplate;
+    doc["availability_topic"] = mqttStatusTopic;
+    doc["device_class"] = (rule.type == ALARM_HIGH || rule.type == ALARM_RISE) ? "heat" : "cold";
+    addMqttDevice(doc);
+
+    char payload[MQTT_DISCOVERY_SIZE];
+    size_t length = serializeJson(doc, payload, sizeof(payload));
+    return mqtt.publish(topic, payload, length, 1, true);
+}
+
+/**
+ * @brief MQTT publisher task
+ *
+ * Woken by the acquisition task whenever the sensordata JSON or an
+ * alarm changed, otherwise every MQTT_RETRY_INTERVAL. Publishes the
+ * discovery configs after every (re)connect and rename, then the alarm
+ * state (first, it is the urgent part) and the newest readings. A message
+ * the client does not accept (outbox full) is not queued here: the task
+ * retries with whatever is newest at that time, so a slow broker only
+ * ever sees the latest sample. Acquisition never waits for this task.
+ *
+ * @param param Unused
+ */
+void mqttTask(void *param)
+{
+    static SensorDataJson state;   // Task-owned copy of the payload, too large for the stack
+    SensorNameTable table;
+    uint32_t connection = 0;       // Connection the discovery was sent on
+    uint32_t namesVersion = 0;     // Name table the discovery was sent with
+    int discoveryNext = 0;         // Next discovery config: sensors, then alarms
+    uint32_t stateVersion = 0;     // Last published sensordata version
+    uint32_t alarmVersion = 0;     // Last published alarm state version
+    bool discovery = MQTT_DISCOVERY_PREFIX[0] != '\0';
+
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MQTT_RETRY_INTERVAL));
+
+        if (!mqtt.connected())
+        {
+            continue;
+        }
+
+        // Retained messages may be gone after a broker restart: send everything again
+        if (mqtt.connection() != connection)
+        {
+            connection = mqtt.connection();
+            namesVersion = 0;
+            stateVersion = 0;
+            alarmVersion = 0;
+        }
+
+        if (discovery)
+        {
+            if (sensorNameTable.version() != namesVersion)
+            {
+                namesVersion = sensorNameTable.read(table);
+                discoveryNext = 0;
+            }
+            while (discoveryNext < NUM_SENSORS + NUM_ALARM_RULES &&
+                   (discoveryNext < NUM_SENSORS ? publishMqttDiscovery(discoveryNext, table.names[discoveryNext])
+                                                : publishMqttAlarmDiscovery(discoveryNext - NUM_SENSORS)))
+            {
+                discoveryNext++;
+            }
+        }
+
+        if (alarmStatus.version() != alarmVersion)
+        {
+            AlarmStatus alarms;
+            uint32_t version = alarmStatus.read(alarms);
+            char payload[ALARM_JSON_SIZE];
+            size_t length = renderAlarmJson(alarms, payload, sizeof(payload));
+            if (mqtt.publish(mqttAlarmTopic, payload, length, 1, true))
+            {
+                alarmVersion = version;
+            }
+        }
+
+        if (sensorDataJson.version() != stateVersion)
+        {
+            uint32_t version = sensorDataJson.read(state);
+            size_t length = min((size_t)state.length, sizeof(state.payload));
+            if (mqtt.publish(mqttStateTopic, state.payload, length, MQTT_STATE_QOS, true))
+            {
+                stateVersion = version;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Create the MQTT client and the publisher task
+ *
+ * Does nothing without MQTT_BROKER_URI. The connection is started in
+ * onWiFiEvent() once an IP address is assigned.
+ */
+void initMqtt()
+{
+    if (MQTT_BROKER_URI[0] == '\0')
+    {
+        Serial.println("MQTT: disabled (no broker)");
+        return;
+    }
+
+    Serial.println("Initializing MQTT...");
+
+    uint8_t mac[6];
+    esp_read_mac(mac, ESP_MAC_WIFI_STA);
+    snprintf(mqttDeviceId, sizeof(mqttDeviceId), "thermohub8_%02x%02x%02x", mac[3], mac[4], mac[5]);
+    snprintf(mqttStateTopic, sizeof(mqttStateTopic), "%s/%s/state", MQTT_BASE_TOPIC, mqttDeviceId);
+    snprintf(mqttStatusTopic, sizeof(mqttStatusTopic), "%s/%s/status", MQTT_BASE_TOPIC, mqttDeviceId);
+    snprintf(mqttAlarmTopic, sizeof(mqttAlarmTopic), "%s/%s/alarms", MQTT_BASE_TOPIC, mqttDeviceId);
+
+    if (!mqtt.begin(MQTT_BROKER_URI, mqttDeviceId, MQTT_USERNAME, MQTT_PASSWORD, mqttStatusTopic, MQTT_OUTBOX_LIMIT))
+    {
+        Serial.println("MQTT: client initialization failed");
+        return;
+    }
+
+    xTaskCreatePinnedToCore(mqttTask, "mqtt", MQTT_TASK_STACK_SIZE, nullptr,
+                            MQTT_TASK_PRIORITY, &mqttTaskHandle, MQTT_TASK_CORE);
+
+    Serial.print("MQTT: publishing to ");
+    Serial.println(mqttStateTopic);
+}
+
+// ============================================================================
+// METRICS FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Serve all metrics in Prometheus text format
+ *
+ * Latencies are exported as histograms in seconds, Modbus results as
+ * one counter with a "result" label. Bus utilization follows from
+ * rate(thermohub8_modbus_transaction_seconds_sum).
+ *
+ * @param request Incoming HTTP request
+ */
+void sendPrometheusMetrics(AsyncWebServerRequest *request)
+{
+    AsyncResponseStream *response = request->beginResponseStream("text/plain; version=0.0.4");
+
+    response->print("# TYPE thermohub8_uptime_seconds gauge\n");
+    printPrometheusCounter(*response, "thermohub8_uptime_seconds", "", esp_timer_get_time() / 1000000);
+
+    response->print("# TYPE thermohub8_heap_free_bytes gauge\n");
+    printPrometheusCounter(*response, "thermohub8_heap_free_bytes", "", ESP.getFreeHeap());
+    response->print("# TYPE thermohub8_heap_min_free_bytes gauge\n");
+    printPrometheusCounter(*response, "thermohub8_heap_min_free_bytes", "", ESP.getMinFreeHeap());
+    response->print("# TYPE thermohub8_heap_max_alloc_bytes gauge\n");
+    printPrometheusCounter(*response, "thermohub8_heap_max_alloc_bytes", "", ESP.getMaxAllocHeap());
+    response->print("# TYPE thermohub8_acquisition_stack_free_bytes gauge\n");
+    printPrometheusCounter(*response, "thermohub8_acquisition_stack_free_bytes", "",
+                           uxTaskGetStackHighWaterMark(acquisitionTaskHandle));
+
+    response->print("# TYPE thermohub8_modbus_transactions_total counter\n");
+    printPrometheusCounter(*response, "thermohub8_modbus_transactions_total", "result=\"success\"", metrics.modbusSuccess);
+    printPrometheusCounter(*response, "thermohub8_modbus_transactions_total", "result=\"timeout\"", metrics.modbusTimeouts);
+    printPrometheusCounter(*response, "thermohub8_modbus_transactions_total", "result=\"crc\"", metrics.modbusCrcErrors);
+    printPrometheusCounter(*response, "thermohub8_modbus_transactions_total", "result=\"exception\"", metrics.modbusExceptions);
+    printPrometheusCounter(*response, "thermohub8_modbus_transactions_total", "result=\"other\"", metrics.modbusOtherErrors);
+    response->print("# TYPE thermohub8_modbus_retries_total counter\n");
+    printPrometheusCounter(*response, "thermohub8_modbus_retries_total", "", metrics.modbusRetries);
+
+    BusHealth health;
+    busHealth.read(health);
+    char labels[24];
+    response->print("# TYPE thermohub8_modbus_device_up gauge\n");
+    for (int i = 0; i < (int)NUM_MODBUS_DEVICES; i++)
+    {
+        snprintf(labels, sizeof(labels), "slave=\"%u\"", MODBUS_DEVICES[i].slaveId);
+        printPrometheusCounter(*response, "thermohub8_modbus_device_up", labels, health.devices[i].state == LINK_OK ? 1 : 0);
+    }
+    response->print("# TYPE thermohub8_modbus_device_failures_total counter\n");
+    for (int i = 0; i < (int)NUM_MODBUS_DEVICES; i++)
+    {
+        snprintf(labels, sizeof(labels), "slave=\"%u\"", MODBUS_DEVICES[i].slaveId);
+        printPrometheusCounter(*response, "thermohub8_modbus_device_failures_total", labels, health.devices[i].failures);
+    }
+    response->print("# TYPE thermohub8_modbus_device_trips_total counter\n");
+    for (int i = 0; i < (int)NUM_MODBUS_DEVICES; i++)
+    {
+        snprintf(labels, sizeof(labels), "slave=\"%u\"", MODBUS_DEVICES[i].slaveId);
+        printPrometheusCounter(*response, "thermohub8_modbus_device_trips_total", labels, health.devices[i].trips);
+    }
+    response->print("# TYPE thermohub8_modbus_channel_failures_total counter\n");
+    for (int i = 0; i < NUM_SENSORS; i++)
+    {
+        snprintf(labels, sizeof(labels), "sensor=\"%d\"", i);
+        printPrometheusCounter(*response, "thermohub8_modbus_channel_failures_total", labels, health.channels[i].failures);
+    }
+
+    response->print("# TYPE thermohub8_modbus_transaction_seconds histogram\n");
+    metrics.modbusTransaction.printPrometheus(*response, "thermohub8_modbus_transaction_seconds", "");
+
+    response->print("# TYPE thermohub8_loop_seconds histogram\n");
+    metrics.loopIteration.printPrometheus(*response, "thermohub8_loop_seconds", "");
+    response->print("# TYPE thermohub8_display_update_seconds histogram\n");
+    metrics.displayUpdate.printPrometheus(*response, "thermohub8_display_update_seconds", "");
+    response->print("# TYPE thermohub8_joystick_update_seconds histogram\n");
+    metrics.joystickUpdate.printPrometheus(*response, "thermohub8_joystick_update_seconds", "");
+
+    response->print("# TYPE thermohub8_http_request_seconds histogram\n");
+    metrics.httpStatus.printPrometheus(*response, "thermohub8_http_request_seconds", "handler=\"status\"");
+    metrics.httpSensorData.printPrometheus(*response, "thermohub8_http_request_seconds", "handler=\"sensordata\"");
+    metrics.httpHistory.printPrometheus(*response, "thermohub8_http_request_seconds", "handler=\"history\"");
+    metrics.httpLog.printPrometheus(*response, "thermohub8_http_request_seconds", "handler=\"log\"");
+    metrics.httpSensor.printPrometheus(*response, "thermohub8_http_request_seconds", "handler=\"sensor\"");
+    metrics.httpMetrics.printPrometheus(*response, "thermohub8_http_request_seconds", "handler=\"metrics\"");
+
+    response->print("# TYPE thermohub8_http_not_found_total counter\n");
+    printPrometheusCounter(*response, "thermohub8_http_not_found_total", "", metrics.httpNotFound);
+
+    AlarmStatus alarms;
+    alarmStatus.read(alarms);
+    response->print("# TYPE thermohub8_alarms_active gauge\n");
+    printPrometheusCounter(*response, "thermohub8_alarms_active", "", __builtin_popcount(alarms.active));
+    response->print("# TYPE thermohub8_alarm_transitions_total counter\n");
+    printPrometheusCounter(*response, "thermohub8_alarm_transitions_total", "", alarms.transitions);
+
+    response->print("# TYPE thermohub8_mqtt_connected gauge\n");
+    printPrometheusCounter(*response, "thermohub8_mqtt_connected", "", mqtt.connected() ? 1 : 0);
+    response->print("# TYPE thermohub8_mqtt_messages_total counter\n");
+    printPrometheusCounter(*response, "thermohub8_mqtt_messages_total", "result=\"published\"", mqtt.published());
+    printPrometheusCounter(*response, "thermohub8_mqtt_messages_total", "result=\"dropped\"", mqtt.dropped());
+    response->print("# TYPE thermohub8_mqtt_outbox_bytes gauge\n");
+    printPrometheusCounter(*response, "thermohub8_mqtt_outbox_bytes", "", mqtt.outboxBytes());
+
+    response->print("# TYPE thermohub8_flash_log_records gauge\n");
+    printPrometheusCounter(*response, "thermohub8_flash_log_records", "", flashLog.storedRecords());
+    response->print("# TYPE thermohub8_flash_log_dropped_total counter\n");
+    printPrometheusCounter(*response, "thermohub8_flash_log_dropped_total", "", flashLog.droppedRecords());
+    response->print("# TYPE thermohub8_flash_log_write_errors_total counter\n");
+    printPrometheusCounter(*response, "thermohub8_flash_log_write_errors_total", "", flashLog.writeErrors());
+    response->print("# TYPE thermohub8_flash_log_max_write_seconds gauge\n");
+    uint32_t maxWrite = flashLog.maxWriteMicros();
+    response->printf("thermohub8_flash_log_max_write_seconds %lu.%06lu\n",
+                     (unsigned long)(maxWrite / 1000000), (unsigned long)(maxWrite % 1000000));
+
+    response->print("# TYPE thermohub8_stream_clients gauge\n");
+    printPrometheusCounter(*response, "thermohub8_stream_clients", "", events.count());
+
+    request->send(response);
+}
+
+/**
+ * @brief Add count, mean and maximum of a histogram to a JSON object
+ */
+void addLatencySummary(JsonObject parent, const char *name, const LatencyHistogram &histogram)
+{
+    JsonObject entry = parent.createNestedObject(name);
+    uint32_t count = histogram.count();
+    entry["count"] = count;
+    entry["mean_us"] = count ? (uint32_t)(histogram.sum() / count) : 0;
+    entry["max_us"] = histogram.maximum();
+}
+
+/**
+ * @brief Serve a metrics summary as JSON
+ *
+ * Same data as /metrics, with latencies reduced to count, mean and
+ * maximum for quick inspection without a Prometheus server.
+ *
+ * @param request Incoming HTTP request
+ */
+void sendMetricsJson(AsyncWebServerRequest *request)
+{
+    StaticJsonDocument<1024> doc;
+
+    doc["uptime"] = (uint32_t)(esp_timer_get_time() / 1000000);
+
+    JsonObject heap = doc.createNestedObject("heap");
+    heap["free"] = ESP.getFreeHeap();
+    heap["min_free"] = ESP.getMinFreeHeap();
+    heap["max_alloc"] = ESP.getMaxAllocHeap();
+
+    JsonObject modbusStats = doc.createNestedObject("modbus");
+    modbusStats["success"] = metrics.modbusSuccess.load();
+    modbusStats["timeouts"] = metrics.modbusTimeouts.load();
+    modbusStats["crc_errors"] = metrics.modbusCrcErrors.load();
+    modbusStats["exceptions"] = metrics.modbusExceptions.load();
+    modbusStats["other_errors"] = metrics.modbusOtherErrors.load();
+    modbusStats["retries"] = metrics.modbusRetries.load();
+    modbusStats["baud_rate"] = modbusBaudRate;
+
+    BusHealth health;
+    busHealth.read(health);
+    JsonArray devices = modbusStats.createNestedArray("devices");
+    for (int i = 0; i < (int)NUM_MODBUS_DEVICES; i++)
+    {
+        const LinkStats &link = health.devices[i];
+        JsonObject device = devices.createNestedObject();
+        device["id"] = i;
+        device["slave"] = MODBUS_DEVICES[i].slaveId;
+        device["state"] = linkStateName(link.state);
+        device["block_read"] = health.blockRead[i];
+        device["polls"] = link.successes;
+        device["failures"] = link.failures;
+        device["consecutive_failures"] = link.consecutive;
+        device["trips"] = link.trips;
+    }
+    JsonArray channels = modbusStats.createNestedArray("channels");
+    for (int i = 0; i < NUM_SENSORS; i++)
+    {
+        const LinkStats &link = health.channels[i];
+        JsonObject channel = channels.createNestedObject();
+        channel["id"] = i;
+        channel["state"] = linkStateName(link.state);
+        channel["failures"] = link.failures;
+        channel["trips"] = link.trips;
+    }
+
+    JsonObject mqttStats = doc.createNestedObject("mqtt");
+    mqttStats["connected"] = mqtt.connected();
+    mqttStats["published"] = mqtt.published();
+    mqttStats["dropped"] = mqtt.dropped();
+    mqttStats["outbox"] = mqtt.outboxBytes();
+
+    AlarmStatus alarms;
+    alarmStatus.read(alarms);
+    JsonObject alarmStats = doc.createNestedObject("alarms");
+    alarmStats["active"] = __builtin_popcount(alarms.active);
+    alarmStats["transitions"] = alarms.transitions;
+
+    JsonObject log = doc.createNestedObject("flash_log");
+    log["records"] = flashLog.storedRecords();
+    log["capacity"] = flashLog.capacityRecords();
+    log["oldest"] = flashLog.oldestTime();
+    log["newest"] = flashLog.newestTime();
+    log["dropped"] = flashLog.droppedRecords();
+    log["write_errors"] = flashLog.writeErrors();
+    log["max_write_us"] = flashLog.maxWriteMicros();
+
+    JsonObject latency = doc.createNestedObject("latency");
+    addLatencySummary(latency, "modbus", metrics.modbusTransaction);
+    addLatencySummary(latency, "loop", metrics.loopIteration);
+    addLatencySummary(latency, "display", metrics.displayUpdate);
+    addLatencySummary(latency, "joystick", metrics.joystickUpdate);
+    addLatencySummary(latency, "http_status", metrics.httpStatus);
+    addLatencySummary(latency, "http_sensordata", metrics.httpSensorData);
+    addLatencySummary(latency, "http_history", metrics.httpHistory);
+    addLatencySummary(latency, "http_log", metrics.httpLog);
+    addLatencySummary(latency, "http_sensor", metrics.httpSensor);
+
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+// ============================================================================
+// FIRMWARE UPDATE FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Keep the new image pending after boot
+ *
+ * Overrides the weak Arduino core hook: without it, the core confirms
+ * every new image right at startup and the rollback never happens.
+ * The image is confirmed by checkFirmwareHealth() instead.
+ */
+extern "C" bool verifyRollbackLater()
+{
+    return true;
+}
+
+/**
+ * @brief Check the upload token
  *
- * @param sensorIndex Current item index (sensor count + menu offset)
- * @param correctXOffset X-axis correction for display bug on rows 3-4
- * @param row Current LCD row (0-3)
+ * Fails closed: without OTA_TOKEN no upload is accepted. The token is
+ * compared in constant time so the response time does not tell how
+ * many leading characters of a guess were right.
+ *
+ * @return true if OTA_TOKEN is set and the request carries it as Bearer token
  */
-void print_menu(int sensorIndex, int correctXOffset, int row)
+bool isOtaAuthorized(AsyncWebServerRequest *request)
 {
-    if (sensorIndex == NUM_SENSORS)
-    {
-        // Separator line after sensors
-        lcd.setCursor(correctXOffset, row);
-        lcd.print("================");
-    }
-    if (sensorIndex == NUM_SENSORS + 1)
+    size_t tokenLength = strlen(OTA_TOKEN);
+    if (tokenLength == 0 || !request->hasHeader("Authorization"))
     {
-        // IP address label
-        lcd.setCursor(correctXOffset, row);
-        lcd.print("IP-Address:");
+        return false;
     }
-    if (sensorIndex == NUM_SENSORS + 2)
+
+    const String &header = request->getHeader("Authorization")->value();
+    if (!header.startsWith("Bearer "))
     {
-        // IP address value
-        lcd.setCursor(correctXOffset, row);
-        lcd.print(WiFi.localIP());
+        return false;
     }
-    if (sensorIndex == NUM_SENSORS + 3)
+
+    const char *given = header.c_str() + 7;
+    size_t givenLength = header.length() - 7;
+    uint8_t difference = givenLength != tokenLength;
+    for (size_t i = 0; i < tokenLength; i++)
     {
-        // Version information
-        lcd.setCursor(correctXOffset, row);
-        lcd.print("Version:     1.0");
+        difference |= (uint8_t)((i < givenLength ? given[i] : 0) ^ OTA_TOKEN[i]);
     }
+    return difference == 0;
 }
 
 /**
- * @brief Update LCD display with current data
- *
- * Renders 4 rows of information starting from the current scroll position.
- * Displays either sensor data or menu items depending on scroll offset.
+ * @brief Body callback of POST /api/v1/ota
  *
- * Note: Uses X-axis correction for rows 3-4 due to LCD library bug
+ * Runs on the AsyncTCP task for every piece of the image as it arrives
+ * and hands it to FirmwareUpdate, which writes it to flash. The first
+ * piece starts the upload unless another one is running; a stalled
+ * upload (no piece for OTA_IDLE_TIMEOUT) is replaced. Pieces of a
+ * rejected request are ignored; onFirmwareUploadComplete() answers it.
  */
-void updateDisplay()
+void onFirmwareUploadBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
 {
-    // Display 4 rows starting from displayOffset
-    for (int row = 0; row < LCD_ROWS; row++)
+    if (index == 0)
     {
-        int sensorIndex = displayOffset + row;
-        int correctXOffset = 0;
+        bool busy = firmwareUpdate.state() == FirmwareUpdate::RECEIVING &&
+                    millis() - firmwareUpdate.lastWrite() < OTA_IDLE_TIMEOUT;
+        if (!isOtaAuthorized(request) || busy || otaRebootAt != 0)
+        {
+            return;
+        }
 
-        // Apply X-axis correction for rows 3 and 4
-        // This is a workaround for a bug in the LCD library
-        if (row > 1)
-            correctXOffset = -4;
+        otaUploadRequest = request;
+        request->onDisconnect([request]()
+                              {
+            if (otaUploadRequest == request) {
+                firmwareUpdate.abort("Connection closed");
+                otaUploadRequest = nullptr;
+            } });
 
-        // Display sensor data if within sensor range
-        if (sensorIndex < NUM_SENSORS)
+        String sha256 = request->hasHeader("X-SHA256") ? request->getHeader("X-SHA256")->value() : String();
+        if (!firmwareUpdate.begin(total, sha256.c_str()))
         {
-            lcd.setCursor(correctXOffset, row);
-            print_sensordata(sensorIndex);
+            return;
         }
-
-        // Display menu items after sensors
-        print_menu(sensorIndex, correctXOffset, row);
+        Serial.println("Firmware upload started (" + String((unsigned long)total) + " bytes)");
     }
-}
 
-/**
- * @brief Scroll display up by one row
- *
- * Decrements the display offset if not already at the top,
- * then refreshes the display.
- */
-void scrollUp()
-{
-    lcd.clear();
-    if (displayOffset > 0)
+    if (request == otaUploadRequest)
     {
-        displayOffset--;
-        updateDisplay();
+        firmwareUpdate.write(data, len, index);
     }
 }
 
 /**
- * @brief Scroll display down by one row
+ * @brief Request callback of POST /api/v1/ota (after the last piece)
  *
- * Increments the display offset if not already at the bottom,
- * then refreshes the display. Maximum offset includes menu items (+4).
+ * Verifies the image and schedules the restart. The records of the
+ * flash log writer and a pending configuration change are written
+ * before the restart.
  */
-void scrollDown()
+void onFirmwareUploadComplete(AsyncWebServerRequest *request)
 {
-    lcd.clear();
-    if (displayOffset < maxDisplayOffset + 4) // +4 for menu items
+    if (strlen(OTA_TOKEN) == 0)
     {
-        displayOffset++;
-        updateDisplay();
+        request->send(403, "application/json", "{\"error\":\"Firmware update disabled, OTA_TOKEN not set\"}");
+        return;
     }
-}
+    if (!isOtaAuthorized(request))
+    {
+        request->send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    if (request->contentLength() == 0)
+    {
+        request->send(400, "application/json", "{\"error\":\"Empty image\"}");
+        return;
+    }
+    if (request != otaUploadRequest)
+    {
+        request->send(409, "application/json", "{\"error\":\"Update in progress\"}");
+        return;
+    }
+    otaUploadRequest = nullptr;
 
-// ============================================================================
-// JOYSTICK CALLBACK FUNCTIONS
-// ============================================================================
+    if (!firmwareUpdate.finish())
+    {
+        Serial.print("Firmware update failed: ");
+        Serial.println(firmwareUpdate.error());
 
-/**
- * @brief Callback for joystick up movement
- * Scrolls the display up by one row
- */
-void onJoystickUp()
-{
-    Serial.println("Joystick: Up");
-    scrollUp();
+        StaticJsonDocument<128> doc;
+        doc["error"] = firmwareUpdate.error();
+        String response;
+        serializeJson(doc, response);
+        request->send(400, "application/json", response);
+        return;
+    }
+
+    Serial.println("Firmware update verified, restarting");
+    flashLog.flush();
+    otaRebootAt = millis() + OTA_REBOOT_DELAY;
+    wakeMainLoop();
+    request->send(200, "application/json", "{\"success\":true,\"restart\":true}");
 }
 
 /**
- * @brief Callback for joystick down movement
- * Scrolls the display down by one row
+ * @brief Send the update state
+ *
+ * Format: {"version":"1.0","partition":"app0","pending_verify":false,
+ *          "state":"receiving","received":524288,"size":1048576,"error":""}
+ *
+ * @param request Incoming HTTP request
  */
-void onJoystickDown()
+void sendFirmwareStatus(AsyncWebServerRequest *request)
 {
-    Serial.println("Joystick: Down");
-    scrollDown();
+    static const char *const STATE_NAMES[] = {"idle", "receiving", "done", "failed"};
+
+    StaticJsonDocument<256> doc;
+    doc["version"] = FIRMWARE_VERSION;
+    doc["partition"] = esp_ota_get_running_partition()->label;
+    doc["pending_verify"] = otaPendingVerify;
+    doc["state"] = STATE_NAMES[firmwareUpdate.state()];
+    doc["received"] = firmwareUpdate.received();
+    doc["size"] = firmwareUpdate.size();
+    doc["error"] = firmwareUpdate.error();
+
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
 }
 
 /**
- * @brief Callback for joystick left movement
- * Currently unused - reserved for future features
+ * @brief Check whether the running image awaits confirmation
+ *
+ * Called once from setup().
  */
-void onJoystickLeft()
+void initFirmwareUpdate()
 {
-    Serial.println("Joystick: Left");
+    otaPendingVerify = FirmwareUpdate::pendingVerify();
+    Serial.print("Firmware " FIRMWARE_VERSION " on partition ");
+    Serial.print(esp_ota_get_running_partition()->label);
+    Serial.println(otaPendingVerify ? " (new, pending verification)" : "");
 }
 
 /**
- * @brief Callback for joystick right movement
- * Currently unused - reserved for future features
+ * @brief Confirm or roll back a new image, restart after an update
+ *
+ * Called from loop(). Staying alive for OTA_HEALTH_MIN_UPTIME proves
+ * that the image does not crash; WiFi and a Modbus answer prove that
+ * it can still be reached and still reads the bus.
  */
-void onJoystickRight()
+void checkFirmwareHealth()
 {
-    Serial.println("Joystick: Right");
+    uint32_t rebootAt = otaRebootAt;
+    if (rebootAt != 0 && (int32_t)(millis() - rebootAt) >= 0)
+    {
+        commitConfig(true);
+        ESP.restart();
+    }
+
+    if (!otaPendingVerify || millis() < OTA_HEALTH_MIN_UPTIME)
+    {
+        return;
+    }
+
+    bool healthy = WiFi.status() == WL_CONNECTED && (!OTA_HEALTH_REQUIRE_MODBUS || metrics.modbusSuccess > 0);
+    if (healthy)
+    {
+        FirmwareUpdate::confirm();
+        otaPendingVerify = false;
+        Serial.println("Firmware confirmed");
+    }
+    else if (millis() >= OTA_HEALTH_TIMEOUT)
+    {
+        Serial.println("Firmware health check failed, rolling back");
+        flashLog.flush();
+        delay(OTA_REBOOT_DELAY);
+        FirmwareUpdate::rollback();
+    }
 }
 
+// ============================================================================
+// WEB SERVER / REST API FUNCTIONS
+// ============================================================================
+
 /**
- * @brief Callback for joystick center position
- * Currently unused - reserved for future features
+ * @brief Serve one asset of the embedded web UI
+ *
+ * The assets are gzip-compressed at build time (scripts/embed_web.py)
+ * and sent from flash unchanged with Content-Encoding: gzip. Assets
+ * referenced as name?v=<etag> may be cached for a year; the page itself
+ * is revalidated on every load and answered with 304 while the
+ * firmware is unchanged. Live values come from /api/v1/stream.
+ *
+ * @param request Incoming HTTP request
+ * @param asset Embedded file (see WebAssets.h)
  */
-void onJoystickCenter()
+void sendWebAsset(AsyncWebServerRequest *request, const WebAsset &asset)
 {
-    Serial.println("Joystick: Center");
+    const char *cacheControl = asset.immutable ? "public, max-age=31536000, immutable" : "no-cache";
+
+    if (request->hasHeader("If-None-Match") &&
+        request->getHeader("If-None-Match")->value().indexOf(asset.etag) >= 0)
+    {
+        AsyncWebServerResponse *response = request->beginResponse(304);
+        response->addHeader("ETag", asset.etag);
+        response->addHeader("Cache-Control", cacheControl);
+        request->send(response);
+        return;
+    }
+
+    AsyncWebServerResponse *response = request->beginResponse(200, asset.contentType, asset.data, asset.length);
+    response->addHeader("Content-Encoding", "gzip");
+    response->addHeader("ETag", asset.etag);
+    response->addHeader("Cache-Control", cacheControl);
+    request->send(response);
 }
 
 /**
- * @brief Callback for joystick button press
- * Currently unused - reserved for future menu navigation
+ * @brief Reject a request whose body was not received completely
+ *
+ * Bodies are collected by BodyAccumulator; if none is available, it
+ * was either larger than the endpoint accepts, missing, or could not
+ * be buffered.
+ *
+ * @param request Incoming HTTP request
+ * @param maxSize Largest body the endpoint accepts
  */
-void onJoystickSwitch()
+void sendBodyError(AsyncWebServerRequest *request, size_t maxSize)
 {
-    Serial.println("Joystick: Switch pressed");
-    // Reserved for menu system implementation
+    if (request->contentLength() > maxSize)
+    {
+        request->send(413, "application/json", "{\"error\":\"Request body too large\"}");
+    }
+    else if (request->contentLength() == 0)
+    {
+        request->send(400, "application/json", "{\"error\":\"Request body required\"}");
+    }
+    else
+    {
+        request->send(503, "application/json", "{\"error\":\"Request body could not be buffered\"}");
+    }
 }
 
 /**
- * @brief Initialize joystick controller
+ * @brief Send the complete sensor configuration
  *
- * Configures the joystick with calibration values, axis inversion,
- * and registers all callback functions for user interaction.
+ * Format: {"sensors":[{"id":0,"name":"Flow","offset":-0.3,"median":3,"smoothing":2},...],
+ *          "devices":[{"id":0,"slave":1,"interval":1000},...],"baud_rate":9600}
+ *
+ * @param request Incoming HTTP request
  */
-void initJoystick()
+void sendSensorConfig(AsyncWebServerRequest *request)
 {
-    Serial.println("Initializing Joystick...");
-
-    joystick.begin();
-    joystick.setThresholds(JOY_MIN_VAL, JOY_MAX_VAL, JOY_CENTER_VAL, JOY_DEADZONE);
-
-    // Invert Y-axis for intuitive up/down navigation
-    // Uncomment to invert X-axis if needed
-    // joystick.setInvertX(true);
-    joystick.setInvertY(true);
-
-    // Enable debug mode for troubleshooting (outputs to serial)
-    // Uncomment to see raw joystick values and events
-    // joystick.setDebugMode(true);
+    SensorNameTable table;
+    AcquisitionSettings settings;
+    sensorNameTable.read(table);
+    acquisitionSettings.read(settings);
 
-    // Register callback functions for joystick events
-    joystick.onUp(onJoystickUp);
-    joystick.onDown(onJoystickDown);
+    StaticJsonDocument<CONFIG_JSON_SIZE> doc;
+    JsonArray sensors = doc.createNestedArray("sensors");
+    for (int i = 0; i < NUM_SENSORS; i++)
+    {
+        JsonObject sensor = sensors.createNestedObject();
+        sensor["id"] = i;
+        sensor["name"] = table.names[i];
+        sensor["offset"] = settings.offsets[i] / 100.0;
+        sensor["median"] = settings.filters[i].median;
+        sensor["smoothing"] = settings.filters[i].smoothing;
+    }
 
-    // These callbacks are currently unused but available for future features
-    joystick.onLeft(onJoystickLeft);
-    joystick.onRight(onJoystickRight);
-    joystick.onCenter(onJoystickCenter);
-    joystick.onSwitch(onJoystickSwitch);
+    JsonArray devices = doc.createNestedArray("devices");
+    for (int i = 0; i < (int)NUM_MODBUS_DEVICES; i++)
+    {
+        JsonObject device = devices.createNestedObject();
+        device["id"] = i;
+        device["slave"] = MODBUS_DEVICES[i].slaveId;
+        device["interval"] = settings.pollIntervals[i];
+    }
+    doc["baud_rate"] = settings.baudRate;
 
-    Serial.println("Joystick initialized");
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
 }
 
-// ============================================================================
-// WIFI FUNCTIONS
-// ============================================================================
-
 /**
- * @brief Initialize WiFi connection
+ * @brief Validate and apply a bulk configuration update
+ *
+ * All entries are optional; fields that are not given keep their value.
+ * The update is validated completely before anything is applied, so a
+ * rejected request changes nothing. Accepted changes are published
+ * immediately and written to flash once (scheduleConfigCommit()).
+ *
+ * Body: {"sensors":[{"id":0,"name":"Flow","offset":-0.3,"median":3,"smoothing":2},...],
+ *        "devices":[{"id":0,"interval":1000},...],"baud_rate":19200}
+ *
+ * A new baud rate takes effect before the next poll; the modules must
+ * have been switched to it beforehand.
  *
- * Connects to the configured WiFi network and displays connection
- * status on the LCD. Times out after 20 attempts (10 seconds).
+ * @param request Incoming HTTP request
+ * @param body Complete request body
+ * @param length Body length
  */
-void initWiFi()
+void applySensorConfig(AsyncWebServerRequest *request, const uint8_t *body, size_t length)
 {
-    lcd.print("Connecting Wifi");
-
-    // Set hostname and begin connection
-    WiFi.setHostname(HOSTNAME);
-    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-
-    // Wait for connection (max 20 attempts = 10 seconds)
-    int attempts = 0;
-    lcd.setCursor(0, 1);
-    while (WiFi.status() != WL_CONNECTED && attempts < 20)
+    StaticJsonDocument<CONFIG_JSON_SIZE> doc;
+    if (deserializeJson(doc, body, length))
     {
-        delay(500);
-        lcd.print(".");
-        attempts++;
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
     }
 
-    delay(100);
-
-    // Display connection result
-    if (WiFi.status() == WL_CONNECTED)
+    // The baud rate probe still owns the settings (single writer)
+    if (baudProbeRunning)
     {
-        lcd.clear();
-        lcd.setCursor(0, 0);
-        lcd.print("Wifi Connected");
-        lcd.setCursor(0, 1);
-        lcd.print("IP: ");
-        lcd.setCursor(-4, 2); // Workaround for display bug
-        lcd.print(WiFi.localIP());
+        request->send(503, "application/json", "{\"error\":\"Bus speed probe running\"}");
+        return;
     }
-    else
+
+    // Work on copies, publish only if everything is valid
+    SensorNameTable table;
+    AcquisitionSettings settings;
+    sensorNameTable.read(table);
+    acquisitionSettings.read(settings);
+
+    for (JsonVariant sensor : doc["sensors"].as<JsonArray>())
     {
-        lcd.clear();
-        lcd.print("WIFI connection failed!");
-    }
+        int id = sensor["id"] | -1;
+        if (id < 0 || id >= NUM_SENSORS)
+        {
+            request->send(400, "application/json", "{\"error\":\"Invalid sensor ID\"}");
+            return;
+        }
 
-    delay(3500);
-}
+        if (!sensor["name"].isNull())
+        {
+            const char *name = sensor["name"] | "";
+            size_t nameLength = strlen(name);
+            if (nameLength == 0 || nameLength > MAX_SENSOR_NAME_LENGTH)
+            {
+                request->send(400, "application/json", "{\"error\":\"Invalid sensor name\"}");
+                return;
+            }
+            memset(table.names[id], 0, sizeof(table.names[id]));
+            memcpy(table.names[id], name, nameLength);
+        }
 
-// ============================================================================
-// WEB SERVER / REST API FUNCTIONS
-// ============================================================================
+        if (!sensor["offset"].isNull())
+        {
+            long offset = lroundf((sensor["offset"] | 0.0f) * 100);
+            if (offset < -CONFIG_MAX_OFFSET || offset > CONFIG_MAX_OFFSET)
+            {
+                request->send(400, "application/json", "{\"error\":\"Offset out of range\"}");
+                return;
+            }
+            settings.offsets[id] = offset;
+        }
 
-/**
- * @brief Generate HTML status page
- *
- * Creates a responsive HTML page displaying all sensor readings.
- * Includes auto-refresh every 5 seconds and links to API endpoints.
- *
- * @return String containing complete HTML document
- */
-String generateStatusHTML()
-{
-    String html = "<!DOCTYPE html><html><head>";
-    html += "<meta charset='UTF-8'>";
-    html += "<meta name='viewport' content='width=device-width, initial-scale=1.0'>";
-    html += "<title>Thermohub8 Status</title>";
-    html += "<style>";
-    html += "body { font-family: Arial, sans-serif; margin: 20px; background-color: #f0f0f0; }";
-    html += "h1 { color: #333; }";
-    html += ".container { max-width: 800px; margin: 0 auto; background: white; padding: 20px; border-radius: 10px; box-shadow: 0 2px 5px rgba(0,0,0,0.1); }";
-    html += ".sensor { display: flex; justify-content: space-between; padding: 10px; margin: 5px 0; background: #f9f9f9; border-radius: 5px; }";
-    html += ".sensor-name { font-weight: bold; }";
-    html += ".sensor-temp { color: #0066cc; }";
-    html += ".refresh-btn { background: #0066cc; color: white; border: none; padding: 10px 20px; border-radius: 5px; cursor: pointer; margin-top: 20px; }";
-    html += ".refresh-btn:hover { background: #0052a3; }";
-    html += "</style>";
-    html += "<script>";
-    html += "function refreshData() { location.reload(); }";
-    html += "setTimeout(refreshData, 5000);"; // Auto-refresh after 5 seconds
-    html += "</script>";
-    html += "</head><body>";
-    html += "<div class='container'>";
-    html += "<h1>Thermohub8 - Sensor Status</h1>";
+        int median = sensor["median"] | (int)settings.filters[id].median;
+        int smoothing = sensor["smoothing"] | (int)settings.filters[id].smoothing;
+        FilterConfig filter = {(uint8_t)median, (uint8_t)smoothing};
+        if (median != filter.median || smoothing != filter.smoothing || !isValidFilterConfig(filter))
+        {
+            request->send(400, "application/json", "{\"error\":\"Invalid filter\"}");
+            return;
+        }
+        settings.filters[id] = filter;
+    }
 
-    // Generate sensor list
-    for (int i = 0; i < NUM_SENSORS; i++)
+    for (JsonVariant device : doc["devices"].as<JsonArray>())
     {
-        html += "<div class='sensor'>";
-        html += "<span class='sensor-name'>" + sensorNames[i] + "</span>";
-        html += "<span class='sensor-temp'>";
-        if (sensorTemperatures[i] > -999.0)
+        int id = device["id"] | -1;
+        if (id < 0 || id >= (int)NUM_MODBUS_DEVICES)
         {
-            html += String(sensorTemperatures[i], 1) + " °C";
+            request->send(400, "application/json", "{\"error\":\"Invalid device ID\"}");
+            return;
         }
-        else
+
+        if (!device["interval"].isNull())
+        {
+            uint32_t interval = device["interval"] | 0;
+            if (interval < CONFIG_MIN_INTERVAL || interval > CONFIG_MAX_INTERVAL)
+            {
+                request->send(400, "application/json", "{\"error\":\"Interval out of range\"}");
+                return;
+            }
+            settings.pollIntervals[id] = interval;
+        }
+    }
+
+    if (!doc["baud_rate"].isNull())
+    {
+        uint32_t baud = doc["baud_rate"] | 0;
+        if (!isValidModbusBaudRate(baud))
         {
-            html += "Error";
+            request->send(400, "application/json", "{\"error\":\"Unsupported baud rate\"}");
+            return;
         }
-        html += "</span>";
-        html += "</div>";
+        settings.baudRate = baud;
     }
 
-    html += "<button class='refresh-btn' onclick='refreshData()'>Refresh</button>";
-    html += "<p style='margin-top: 20px; color: #666; font-size: 12px;'>";
-    html += "API Endpoint: <a href='/api/v1/sensordata'>/api/v1/sensordata</a><br>";
-    html += "Auto-refresh every 5 seconds";
-    html += "</p>";
-    html += "</div>";
-    html += "</body></html>";
+    bool changed = sensorNameTable.publishIfChanged(table);
+    changed = acquisitionSettings.publishIfChanged(settings) || changed;
+    if (changed)
+    {
+        scheduleConfigCommit();
+    }
 
-    return html;
+    sendSensorConfig(request);
 }
 
 /**
  * @brief Initialize web server and REST API endpoints
  *
  * Sets up HTTP routes for:
- * - GET  /                    - HTML status page
+ * - GET  /                    - Status page (static, see web/)
+ * - GET  /app.js, /style.css  - Static assets of the status page
  * - GET  /api/v1/sensordata   - JSON sensor data
+ * - GET  /api/v1/sensordata.bin - Binary sensor data (fixed layout)
+ * - GET  /api/v1/statistics   - Filtered values with min/max/mean per window
+ * - GET  /api/v1/alarms       - Alarm rules and their state
+ * - GET  /api/v1/stream       - Live readings (Server-Sent Events)
+ * - GET  /api/v1/history      - Downsampled history (?from=&to=&step=)
+ * - GET  /api/v1/log          - Raw records from the flash log (?from=&to=)
+ * - GET  /api/v1/metrics      - Metrics summary (JSON)
+ * - GET  /metrics             - Metrics in Prometheus text format
+ * - GET  /api/v1/sensors      - Sensor configuration (names, offsets, filters, poll intervals)
+ * - PUT  /api/v1/sensors      - Update the configuration in one request
  * - POST /api/v1/sensor       - Update sensor name
+ * - GET  /api/v1/ota          - Firmware version and update state
+ * - POST /api/v1/ota          - Upload a firmware image (raw body, X-SHA256 header)
  */
 void initWebServer()
 {
     Serial.println("Initializing Web Server...");
 
-    // Route: Root page - HTML status display
-    server.on("/", HTTP_GET, [](AsyncWebServerRequest *request)
-              { request->send(200, "text/html", generateStatusHTML()); });
+    // Routes: Web UI - static files from web/, gzip-compressed in flash
+    for (const WebAsset &asset : WEB_ASSETS)
+    {
+        server.on(asset.path, HTTP_GET, [&asset](AsyncWebServerRequest *request)
+                  { ScopedLatency latency(metrics.httpStatus);
+                    sendWebAsset(request, asset); });
+    }
 
     // Route: API endpoint - Get all sensor data as JSON
     // Returns: {"sensors":[{"id":0,"name":"Sensor 1","value":23.5,"unit":"°C"},...]}
+    // Served from the per-cycle cache, supports ETag / If-None-Match
     server.on("/api/v1/sensordata", HTTP_GET, [](AsyncWebServerRequest *request)
+              { ScopedLatency latency(metrics.httpSensorData);
+                sendSensorDataJson(request); });
+
+    // Route: API endpoint - Sensor data in a fixed binary layout
+    // Returns: 12-byte header + 4 bytes per sensor (see SensorRender.h)
+    server.on("/api/v1/sensordata.bin", HTTP_GET, [](AsyncWebServerRequest *request)
+              { ScopedLatency latency(metrics.httpSensorData);
+                sendSensorDataBinary(request); });
+
+    // Route: API endpoint - Rolling statistics of the filtered values
+    // Returns: {"windows":[60,300,3600],"sensors":[{"id":0,"value":23.45,"raw":23.47,"windows":[{"min":..},...]}]}
+    server.on("/api/v1/statistics", HTTP_GET, [](AsyncWebServerRequest *request)
+              { ScopedLatency latency(metrics.httpSensorData);
+                sendSensorStatistics(request); });
+
+    // Route: API endpoint - Alarm rules and state
+    // Returns: {"active":1,"alarms":[{"id":0,"label":"Overheat","active":true,...}]}
+    server.on("/api/v1/alarms", HTTP_GET, [](AsyncWebServerRequest *request)
+              { ScopedLatency latency(metrics.httpSensorData);
+                sendAlarms(request); });
+
+    // Route: API endpoint - Downsampled history from RAM
+    // Returns: {"now":3600,"interval":10,"step":60,"rows":[[0,21.50,...],...]}
+    server.on("/api/v1/history", HTTP_GET, [](AsyncWebServerRequest *request)
+              { ScopedLatency latency(metrics.httpHistory);
+                sendHistory(request); });
+
+    // Route: API endpoint - Persistent log from LittleFS
+    // Returns: binary records (uint32 Unix time + int16 per channel), see X-Record-Size
+    server.on("/api/v1/log", HTTP_GET, [](AsyncWebServerRequest *request)
+              { ScopedLatency latency(metrics.httpLog);
+                sendFlashLog(request); });
+
+    // Route: Metrics - Prometheus text format
+    server.on("/metrics", HTTP_GET, [](AsyncWebServerRequest *request)
+              { ScopedLatency latency(metrics.httpMetrics);
+                sendPrometheusMetrics(request); });
+
+    // Route: API endpoint - Metrics summary as JSON
+    // Returns: {"uptime":3600,"heap":{...},"modbus":{...},"latency":{...}}
+    server.on("/api/v1/metrics", HTTP_GET, [](AsyncWebServerRequest *request)
+              { ScopedLatency latency(metrics.httpMetrics);
+                sendMetricsJson(request); });
+
+    // Route: API endpoint - Sensor configuration
+    // Returns: {"sensors":[{"id":0,"name":"Flow","offset":-0.3,"median":1,"smoothing":0},...],"devices":[{"id":0,"slave":1,"interval":1000}]}
+    server.on("/api/v1/sensors", HTTP_GET, [](AsyncWebServerRequest *request)
+              { ScopedLatency latency(metrics.httpSensor);
+                sendSensorConfig(request); });
+
+    // Route: API endpoint - Bulk configuration update
+    // PUT body: same format as GET, all fields optional
+    server.on("/api/v1/sensors", HTTP_PUT, [](AsyncWebServerRequest *request)
               {
-        StaticJsonDocument<1024> doc;
-        JsonArray sensors = doc.createNestedArray("sensors");
-        
-        // Build JSON array with all sensor data
-        for (int i = 0; i < NUM_SENSORS; i++) {
-            JsonObject sensor = sensors.createNestedObject();
-            sensor["id"] = i;
-            sensor["name"] = sensorNames[i];
-            sensor["value"] = round(sensorTemperatures[i] * 10) / 10.0;  // 1 decimal place
-            sensor["unit"] = "°C";
-        }
-        
-        String response;
-        serializeJson(doc, response);
-        request->send(200, "application/json", response); });
+            ScopedLatency latency(metrics.httpSensor);
+
+            const char *body = BodyAccumulator::body(request);
+            if (body == nullptr) {
+                sendBodyError(request, CONFIG_BODY_MAX);
+                return;
+            }
+            applySensorConfig(request, (const uint8_t*)body, BodyAccumulator::length(request)); },
+              NULL, // Upload handler (unused)
+              [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
+              { BodyAccumulator::append(request, data, len, index, total, CONFIG_BODY_MAX); });
 
     // Route: API endpoint - Update sensor name
     // POST body: {"id": 0, "name": "New Name"}
     // Returns: {"success": true, "id": 0, "name": "New Name"}
-    server.on("/api/v1/sensor", HTTP_POST, [](AsyncWebServerRequest *request) {}, // Request handler (unused for POST with body)
-              NULL,                                                               // Upload handler (unused)
-              [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
+    server.on("/api/v1/sensor", HTTP_POST, [](AsyncWebServerRequest *request)
               {
-            // Parse JSON request body
+            ScopedLatency latency(metrics.httpSensor);
+
+            const char *body = BodyAccumulator::body(request);
+            if (body == nullptr) {
+                sendBodyError(request, SENSOR_BODY_MAX);
+                return;
+            }
+
+            // Parse the complete body straight from the request buffer
             StaticJsonDocument<256> doc;
-            DeserializationError error = deserializeJson(doc, (const char*)data);
+            DeserializationError error = deserializeJson(doc, body, BodyAccumulator::length(request));
             
             if (error) {
                 request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
@@ -796,26 +4162,45 @@ void initWebServer()
                 return;
             }
             
-            // Save new name and update display
-            saveSensorName(sensorId, String(newName));
-            updateDisplay();
+            // Save new name (loop() picks it up for the display)
+            saveSensorName(sensorId, newName);
             
             // Build success response
+            SensorNameTable table;
+            sensorNameTable.read(table);
+
             StaticJsonDocument<128> responseDoc;
             responseDoc["success"] = true;
             responseDoc["id"] = sensorId;
-            responseDoc["name"] = sensorNames[sensorId];
+            responseDoc["name"] = table.names[sensorId];
             
             String response;
             serializeJson(responseDoc, response);
-            request->send(200, "application/json", response); });
+            request->send(200, "application/json", response); },
+              NULL, // Upload handler (unused)
+              [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
+              { BodyAccumulator::append(request, data, len, index, total, SENSOR_BODY_MAX); });
+
+    // Route: Firmware update - image streamed straight into the OTA partition
+    // POST body: raw .bin image, header X-SHA256: <hex digest>
+    server.on("/api/v1/ota", HTTP_GET, [](AsyncWebServerRequest *request)
+              { sendFirmwareStatus(request); });
+    server.on("/api/v1/ota", HTTP_POST, onFirmwareUploadComplete,
+              NULL, // Upload handler (unused, raw body)
+              onFirmwareUploadBody);
 
     // 404 handler for unknown routes
     server.onNotFound([](AsyncWebServerRequest *request)
-                      { request->send(404, "application/json", "{\"error\":\"Not Found\"}"); });
+                      { metrics.httpNotFound++;
+                        request->send(404, "application/json", "{\"error\":\"Not Found\"}"); });
+
+    // Route: Live stream - Server-Sent Events with changed readings
+    // Event "readings": {"sensors":[{"id":0,"value":23.5},...]}
+    events.onConnect(onStreamConnect);
+    server.addHandler(&events);
 
-    server.begin();
-    Serial.println("Web Server started");
+    // server.begin() follows in onWiFiEvent() once an IP is assigned
+    Serial.println("Web Server routes registered");
 }
 
 // ============================================================================
@@ -828,15 +4213,16 @@ void initWebServer()
  * Initializes all system components in the following order:
  * 1. Serial communication for debugging
  * 2. Status LED
- * 3. Non-volatile storage (sensor names)
+ * 3. Power management and non-volatile storage (sensor names)
  * 4. LCD display
- * 5. Modbus communication
+ * 5. Modbus communication, alarm outputs and acquisition task
  * 6. Joystick controller
- * 7. WiFi connection
- * 8. Web server
+ * 7. Web server routes and MQTT publisher
+ * 8. WiFi connection (background)
  *
- * After initialization, displays a ready message and starts
- * the main sensor display.
+ * Nothing here waits: the first readings replace the splash screen as
+ * soon as the acquisition task delivers them, the web server starts
+ * when WiFi reports an IP address.
  */
 void setup()
 {
@@ -847,31 +4233,30 @@ void setup()
     pinMode(STATUS_LED, OUTPUT);
     digitalWrite(STATUS_LED, LOW);
 
-    delay(1000);
     Serial.println("=== Thermohub8 Starting ===");
 
-    // Initialize all temperature readings with error value
-    for (int i = 0; i < NUM_SENSORS; i++)
-    {
-        sensorTemperatures[i] = -999.9;
-    }
+    // setup() and loop() run in the same task
+    mainLoopTaskHandle = xTaskGetCurrentTaskHandle();
+
+    // Sensor data ETags of this boot (see formatSensorDataEtag())
+    etagNonce = esp_random();
 
     // Initialize all system components
-    initPreferences(); // Load sensor names from flash
-    initDisplay();     // Setup LCD and show welcome message
-    initModbus();      // Configure Modbus communication
-    initJoystick();    // Setup joystick with callbacks
-    initWiFi();        // Connect to WiFi network
-    initWebServer();   // Start HTTP server and API
-
-    // Display ready message
-    lcd.clear();
-    lcd.print("Thermohub8 Ready");
-    delay(1000);
-    lcd.clear();
+    initPowerManagement(); // Frequency scaling / light sleep (POWER_MODE)
+    initFirmwareUpdate();  // Is this a new image awaiting its health check?
+    initPreferences();     // Load sensor names from flash
+    initHistory();         // Reserve history memory
+    initFlashLog();        // Mount LittleFS, start the log writer
+    initDisplay();         // Setup LCD and show welcome message
+    initModbus();          // Configure Modbus communication
+    initAlarms();          // Alarm outputs and rule engine
+    initAcquisition();     // Start background sensor polling
+    initJoystick();        // Setup joystick with callbacks
+    initWebServer();       // Register HTTP routes (server starts on WiFi IP)
+    initMqtt();            // MQTT client and publisher task (connects on WiFi IP)
+    initWiFi();            // Connect to WiFi network in the background
 
-    // Show initial sensor display
-    updateDisplay();
+    Serial.println("Thermohub8 Ready");
 }
 
 // ============================================================================
@@ -882,23 +4267,68 @@ void setup()
  * @brief Arduino main loop - runs continuously
  *
  * Main program loop that performs the following tasks:
- * 1. Updates sensor readings via Modbus (every MODBUS_UPDATE_INTERVAL)
- * 2. Refreshes LCD display with current data
- * 3. Polls joystick for user input
+ * 1. Takes over new sensor readings from the acquisition task
+ * 2. Refreshes LCD display when data or scroll position changed
+ * 3. Pushes alarm changes and changed readings to live stream clients
+ * 4. Records history rows (every HISTORY_INTERVAL)
+ * 5. Queues flash log records (every FLASH_LOG_INTERVAL)
+ * 6. Retries the WiFi connection while disconnected
+ * 7. Switches the backlight off after the idle timeout
+ * 8. Writes pending configuration changes to flash
+ * 9. Dispatches joystick events (or polls the joystick)
  *
- * Loop delay: 10ms (100 Hz update rate)
+ * Joystick event mode: sleeps until woken by new data, a joystick event
+ * or WiFi change, at most LOOP_IDLE_TIMEOUT.
+ * Polling mode: loop delay 10ms (100 Hz update rate).
  */
 void loop()
 {
-    // Update sensor data from Modbus (time-controlled)
+    int64_t iterationStart = esp_timer_get_time();
+
+    // Take over new sensor data from the acquisition task (non-blocking)
     updateSensorData();
 
-    // Refresh LCD display with current values
-    updateDisplay();
+    // Refresh LCD display (only changed characters are sent)
+    refreshDisplay();
+
+    // Push alarm changes and changed readings to /api/v1/stream clients
+    publishStreamAlarms();
+    publishStreamUpdates();
+
+    // Record history (time-controlled)
+    updateHistory();
+
+    // Queue a flash log record (written by the log task)
+    updateFlashLog();
+
+    // Reconnect WiFi if the driver gave up
+    maintainWiFi();
+
+    // Backlight timeout (LCD_BACKLIGHT_TIMEOUT)
+    updateBacklight();
+
+    // Write configuration changes to flash (debounced)
+    commitConfig();
+
+    // Confirm a new firmware image, restart after an update
+    checkFirmwareHealth();
 
     // Process joystick input and trigger callbacks
-    joystick.update();
+    {
+        ScopedLatency latency(metrics.joystickUpdate);
+        joystick.update();
+    }
 
-    // Small delay to prevent excessive CPU usage
-    delay(10);
+    metrics.loopIteration.record((uint32_t)(esp_timer_get_time() - iterationStart));
+
+    if (joystickEventMode)
+    {
+        // Sleep until there is something to do
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOOP_IDLE_TIMEOUT));
+    }
+    else
+    {
+        // Small delay to prevent excessive CPU usage
+        delay(10);
+    }
 }
@@ -0,0 +1,130 @@
+"""Embed the static web UI (web/) into the firmware as gzip-compressed arrays.
+
+Runs before every PlatformIO build of the ESP32 firmware (extra_scripts in
+platformio.ini) and can be run by hand for the Arduino IDE:
+
+    python scripts/embed_web.py
+
+Every file in web/ is compressed with gzip (level 9, no timestamp, so the
+output only changes with the content) and written to esp32/WebAssets.h
+together with its content type and an ETag derived from the compressed
+bytes. In index.html, "{{name}}" is replaced by the ETag of asset "name",
+so references like "app.js?v={{app.js}}" change whenever the asset does and
+the assets themselves can be cached indefinitely. The header is only
+rewritten when its content changes.
+"""
+
+import gzip
+import hashlib
+import os
+
+CONTENT_TYPES = {
+    ".html": "text/html",
+    ".css": "text/css",
+    ".js": "application/javascript",
+    ".svg": "image/svg+xml",
+    ".ico": "image/x-icon",
+}
+
+INDEX = "index.html"
+
+
+def compress(data):
+    return gzip.compress(data, compresslevel=9, mtime=0)
+
+
+def etag(data):
+    return hashlib.sha1(data).hexdigest()[:8]
+
+
+def c_array(name, data):
+    lines = []
+    for offset in range(0, len(data), 16):
+        lines.append("    " + ", ".join("0x%02x" % b for b in data[offset:offset + 16]) + ",")
+    return "const uint8_t %s[] PROGMEM = {\n%s\n};\n" % (name, "\n".join(lines))
+
+
+def build_assets(web_dir):
+    """Return (url, content type, gzip data, etag, immutable) per file, index first."""
+    names = sorted(n for n in os.listdir(web_dir) if os.path.splitext(n)[1] in CONTENT_TYPES)
+    assets = []
+    tags = {}
+
+    for name in names:
+        if name == INDEX:
+            continue
+        with open(os.path.join(web_dir, name), "rb") as f:
+            data = compress(f.read())
+        tags[name] = etag(data)
+        assets.append(("/" + name, CONTENT_TYPES[os.path.splitext(name)[1]], data, tags[name], True))
+
+    if INDEX in names:
+        with open(os.path.join(web_dir, INDEX), "r", encoding="utf-8") as f:
+            html = f.read()
+        for name, tag in tags.items():
+            html = html.replace("{{%s}}" % name, tag)
+        data = compress(html.encode("utf-8"))
+        assets.insert(0, ("/", "text/html", data, etag(data), False))
+
+    return assets
+
+
+def render_header(assets):
+    out = [
+        "// Generated by scripts/embed_web.py from web/ - do not edit",
+        "",
+        "#ifndef WEB_ASSETS_H",
+        "#define WEB_ASSETS_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "// Statische Datei der Weboberfläche (gzip-komprimiert im Flash)",
+        "struct WebAsset {",
+        "    const char *path;        // URL",
+        "    const char *contentType;",
+        "    const uint8_t *data;     // gzip-Daten",
+        "    size_t length;",
+        "    const char *etag;",
+        "    bool immutable;          // Über ?v=<etag> versioniert, darf unbegrenzt gecacht werden",
+        "};",
+        "",
+    ]
+    for i, (path, _, data, _, _) in enumerate(assets):
+        out.append("// %s (%d bytes gzip)" % (path, len(data)))
+        out.append(c_array("WEB_ASSET_%d" % i, data))
+
+    out.append("const WebAsset WEB_ASSETS[] = {")
+    for i, (path, content_type, data, tag, immutable) in enumerate(assets):
+        out.append('    {"%s", "%s", WEB_ASSET_%d, %d, "\\"%s\\"", %s},'
+                   % (path, content_type, i, len(data), tag, "true" if immutable else "false"))
+    out.append("};")
+    out.append("")
+    out.append("constexpr size_t WEB_ASSET_COUNT = sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]);")
+    out.append("")
+    out.append("#endif // WEB_ASSETS_H")
+    out.append("")
+    return "\n".join(out)
+
+
+def generate(project_dir):
+    web_dir = os.path.join(project_dir, "web")
+    target = os.path.join(project_dir, "esp32", "WebAssets.h")
+
+    header = render_header(build_assets(web_dir))
+
+    current = None
+    if os.path.exists(target):
+        with open(target, "r", encoding="utf-8") as f:
+            current = f.read()
+    if header != current:
+        with open(target, "w", encoding="utf-8", newline="\n") as f:
+            f.write(header)
+        print("embed_web: updated %s" % os.path.relpath(target, project_dir))
+
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO (SCons)
+    generate(env["PROJECT_DIR"])  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        generate(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
@@ -0,0 +1,46 @@
+// Thermohub8 status page: the page itself is static and cached, live
+// values come from /api/v1/stream (first event = all sensors with names,
+// then only changed ones). Browsers without EventSource poll
+// /api/v1/sensordata, which answers 304 while nothing changed.
+(function () {
+  var list = document.getElementById('sensors');
+  var rows = {};
+
+  function show(s) {
+    var row = rows[s.id];
+    if (!row) {
+      row = rows[s.id] = document.createElement('div');
+      row.className = 'sensor';
+      row.innerHTML = "<span class='sensor-name'></span><span class='sensor-temp'></span>";
+      list.appendChild(row);
+    }
+    if (s.name !== undefined) row.firstChild.textContent = s.name;
+    row.lastChild.textContent = s.value !== null
+      ? s.value.toFixed(1) + ' °C' + (s.status == 'stale' ? ' (stale)' : '')
+      : 'Error';
+  }
+
+  function update(data) {
+    data.sensors.forEach(show);
+  }
+
+  function load() {
+    var xhr = new XMLHttpRequest();
+    xhr.open('GET', '/api/v1/sensordata');
+    xhr.onload = function () {
+      if (xhr.status == 200) update(JSON.parse(xhr.responseText));
+    };
+    xhr.send();
+  }
+
+  document.getElementById('refresh').onclick = load;
+
+  if (window.EventSource) {
+    new EventSource('/api/v1/stream').addEventListener('readings', function (e) {
+      update(JSON.parse(e.data));
+    });
+  } else {
+    load();
+    setInterval(load, 5000);
+  }
+})();